@@ -0,0 +1,118 @@
+/*
+ *  decode.cxx
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include <ers/BinaryStreamOutput.h>
+#include <ers/ers.h>
+#include <ers/StandardStreamOutput.h>
+
+/** \file decode.cxx
+  * Prints issues stored in files written by the "binfile" ERS stream.
+  */
+
+void print_description()
+{
+    std::cout << "Description:" << std::endl;
+    std::cout << "\tDecodes issues stored in binary files written by the ERS \"binfile\" stream" << std::endl;
+    std::cout << "\tand prints them in the same format as the ERS text streams." << std::endl;
+}
+
+void print_usage()
+{
+    std::cout << "Usage: ers_decode [-h]|[--help] [-v verbosity] file ..." << std::endl;
+    std::cout << "Options/Arguments:" << std::endl;
+    std::cout << "\t[-h]|[--help]\tprints this help screen." << std::endl;
+    std::cout << "\t-v verbosity\tERS verbosity level used for printing issues, the default is taken" << std::endl;
+    std::cout << "\t\t\tfrom the TDAQ_ERS_VERBOSITY_LEVEL environment variable." << std::endl;
+    std::cout << "\tfile\t\tname of a binary file to be decoded." << std::endl;
+}
+
+bool decode( const char * file_name )
+{
+    std::ifstream in( file_name, std::ios::binary );
+    if ( !in )
+    {
+	std::cerr << "Can not open \"" << file_name << "\" file" << std::endl;
+	return false;
+    }
+
+    std::ostringstream content;
+    content << in.rdbuf();
+    const std::string & data = content.str();
+
+    if (    data.size() < sizeof( ers::BinaryStreamOutput::Magic )
+	 || memcmp( data.data(), ers::BinaryStreamOutput::Magic, sizeof( ers::BinaryStreamOutput::Magic ) ) )
+    {
+	std::cerr << "\"" << file_name << "\" is not an ERS binary file" << std::endl;
+	return false;
+    }
+
+    const char * begin = data.data() + sizeof( ers::BinaryStreamOutput::Magic );
+    const char * end = data.data() + data.size();
+    try {
+	while ( begin != end )
+	{
+	    std::unique_ptr<ers::Issue> issue( ers::BinaryStreamOutput::decode( begin, end ) );
+	    if ( !issue )
+	    {
+		std::cerr << "\"" << file_name << "\" file ends with an incomplete record of "
+			  << end - begin << " bytes" << std::endl;
+		break;
+	    }
+	    ers::StandardStreamOutput::println( std::cout, *issue, ers::verbosity_level() );
+	}
+    }
+    catch ( ers::BadBinaryData & ex ) {
+	std::cerr << "\"" << file_name << "\" file can not be decoded at offset "
+		  << begin - data.data() << ": " << ex.message() << std::endl;
+	return false;
+    }
+    return true;
+}
+
+int main( int argc, char** argv )
+{
+    int i = 1;
+    for ( ; i < argc && argv[i][0] == '-'; ++i )
+    {
+	if ( !strcmp( argv[i], "--help" ) || !strcmp( argv[i], "-h" ) )
+	{
+	    print_usage();
+	    print_description();
+	    return 0;
+	}
+	else if ( !strcmp( argv[i], "-v" ) && i + 1 < argc )
+	{
+	    ers::Configuration::instance().verbosity_level( atoi( argv[++i] ) );
+	}
+	else
+	{
+	    print_usage();
+	    return 1;
+	}
+    }
+
+    if ( i == argc )
+    {
+	print_usage();
+	return 1;
+    }
+
+    bool ok = true;
+    for ( ; i < argc; ++i )
+    {
+	ok = decode( argv[i] ) && ok;
+    }
+    return ok ? 0 : 1;
+}
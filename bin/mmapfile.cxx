@@ -0,0 +1,125 @@
+/*
+ *  mmapfile.cxx
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iostream>
+
+#include <ers/internal/MappedFileStream.h>
+
+/** \file mmapfile.cxx
+  * Prints the content of a file written by the "mmapfile" ERS stream.
+  */
+
+void print_description()
+{
+    std::cout << "Description:" << std::endl;
+    std::cout << "\tPrints issues stored in a file written by the ERS \"mmapfile\" stream." << std::endl;
+    std::cout << "\tRecords which have not been completely written are reported to the standard error." << std::endl;
+}
+
+void print_usage()
+{
+    std::cout << "Usage: ers_read_mmapfile [-h]|[--help] file" << std::endl;
+    std::cout << "Options/Arguments:" << std::endl;
+    std::cout << "\t[-h]|[--help]\tprints this help screen." << std::endl;
+    std::cout << "\tfile\t\tname of the file to be printed." << std::endl;
+}
+
+int main( int argc, char** argv )
+{
+    if ( argc != 2 || !strcmp( argv[1], "--help" ) || !strcmp( argv[1], "-h" ) )
+    {
+	print_usage();
+	print_description();
+	return argc == 2 ? 0 : 1;
+    }
+
+    int fd = ::open( argv[1], O_RDONLY );
+    struct stat st;
+    if ( fd < 0 || ::fstat( fd, &st ) )
+    {
+	std::cerr << "Can not open \"" << argv[1] << "\" file: " << strerror( errno ) << std::endl;
+	return 1;
+    }
+
+    size_t file_size = st.st_size;
+    if ( file_size < sizeof( ers::MappedFileHeader ) )
+    {
+	std::cerr << "\"" << argv[1] << "\" is not an ERS memory mapped file" << std::endl;
+	return 1;
+    }
+
+    void * data = ::mmap( 0, file_size, PROT_READ, MAP_SHARED, fd, 0 );
+    if ( data == MAP_FAILED )
+    {
+	std::cerr << "Can not map \"" << argv[1] << "\" file: " << strerror( errno ) << std::endl;
+	return 1;
+    }
+
+    const char * begin = static_cast<const char *>( data );
+    const ers::MappedFileHeader * header = static_cast<const ers::MappedFileHeader *>( data );
+    if (    memcmp( header->magic, ers::MappedFileHeader::Magic, sizeof( header->magic ) )
+	 || header->capacity > file_size
+	 || header->data_offset > header->capacity )
+    {
+	std::cerr << "\"" << argv[1] << "\" is not an ERS memory mapped file" << std::endl;
+	return 1;
+    }
+
+    // the records are found by their sizes, the tail is not used since the writers could
+    // have been stopped before updating it
+    uint64_t end = header->capacity;
+    uint64_t offset = header->data_offset;
+    size_t incomplete = 0;
+
+    while ( offset + sizeof( ers::MappedRecordHeader ) <= end )
+    {
+	const ers::MappedRecordHeader * record =
+		reinterpret_cast<const ers::MappedRecordHeader *>( begin + offset );
+	uint32_t size = record->size.load( std::memory_order_acquire );
+
+	// zero size marks the free space and the padding record the unused end of the file
+	if ( !size || size == ers::MappedRecordHeader::PaddingSize )
+	    break;
+
+	uint64_t next = offset + ers::MappedRecordHeader::record_size( size );
+	if ( next > end )
+	{
+	    std::cerr << "Record of " << size << " bytes at offset " << offset
+		      << " exceeds the end of the file" << std::endl;
+	    ++incomplete;
+	    break;
+	}
+
+	if ( record->state.load( std::memory_order_acquire ) == ers::MappedRecordHeader::Committed )
+	{
+	    std::cout.write( reinterpret_cast<const char *>( record + 1 ), size );
+	}
+	else
+	{
+	    std::cerr << "Incomplete record of " << size << " bytes at offset " << offset << std::endl;
+	    ++incomplete;
+	}
+	offset = next;
+    }
+
+    uint64_t dropped = header->dropped.load( std::memory_order_relaxed );
+    if ( incomplete || dropped )
+    {
+	std::cerr << incomplete << " incomplete record(s), " << dropped
+		  << " issue(s) did not fit into the file" << std::endl;
+    }
+
+    ::munmap( data, file_size );
+    ::close( fd );
+    return 0;
+}
@@ -34,7 +34,7 @@ namespace ers
 		  const system_clock::time_point & time,
 		  const std::string & message,
 		  const std::vector<std::string> & qualifiers,
-		  const std::map<std::string, std::string> & parameters,
+		  const string_map & parameters,
                   const ers::Issue * cause = 0 )
           : ers::Issue( severity, time, context, message, qualifiers, parameters, cause ),
             m_type( type ) 
@@ -0,0 +1,57 @@
+/*
+ *  BinaryStreamOutput.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file BinaryStreamOutput.h This file defines the binary encoding of ERS issues.
+  * \brief ers header file
+  */
+
+#ifndef ERS_BINARY_STREAM_OUTPUT_H
+#define ERS_BINARY_STREAM_OUTPUT_H
+
+#include <stdint.h>
+
+#include <string>
+
+#include <ers/Issue.h>
+
+ERS_DECLARE_ISSUE(  ers,
+		    BadBinaryData,
+		    "binary issue data are corrupted: " << reason,
+		    ((std::string)reason ) )
+
+namespace ers
+{
+    /** This class provides a namespace for the functions that convert ERS issues to a compact binary
+      * representation and back. An encoded issue contains its class name, severity, time, message, context,
+      * qualifiers, parameters and the encoded chain of its causes. Stack frames are not encoded.
+      * Each issue is stored as a record which starts with the size of the rest of the record and its
+      * format version, so the records can be written one after another to a file or a socket.
+      * Integer numbers are stored as LEB128 variable length integers and strings as their size followed
+      * by their characters.
+      *
+      * \brief Binary encoding of ERS issues.
+      */
+    struct BinaryStreamOutput
+    {
+	static const uint8_t Version = 1;			/**< \brief version of the record format */
+
+	static const char Magic[8];				/**< \brief marks the beginning of a binary file */
+
+	/** Appends the record for the given issue to the output string. */
+	static void encode( std::string & out, const Issue & issue );
+
+	/** Decodes the issue stored in the record at the beginning of the given data and moves the
+	  * data pointer to the next record.
+	  * \return new issue or 0 if the data do not contain the whole record
+	  * \throw ers::BadBinaryData the data can not be decoded
+	  */
+	static Issue * decode( const char * & data, const char * end );
+    };
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ *  CallSite.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file CallSite.h This file defines the ers::CallSite class, which describes
+  * a place in the code where issues are created with the ERS_HERE macro.
+  * \brief ers header file
+  */
+
+#ifndef ERS_CALL_SITE_H
+#define ERS_CALL_SITE_H
+
+#include <stdint.h>
+
+#include <string_view>
+
+namespace ers
+{
+    /** This class describes a single place in the code where issues are created. An instance of
+      * this class is statically allocated by the ERS_HERE macro and is initialised when the macro
+      * is executed for the first time. At this point the call site gets an identifier, which is
+      * unique in the current process, and the strings which are derived from the function and file
+      * names are rendered. The call sites are never destroyed, so the issues which are reported
+      * at exit can still refer to them.
+      *
+      * \brief Static descriptor of a place in the code.
+      */
+    class CallSite
+    {
+      public:
+	CallSite(	const char * package_name,
+			const char * file_name,
+			int line_number,
+			const char * function_name );
+
+	CallSite( const CallSite & ) = delete;
+	CallSite & operator=( const CallSite & ) = delete;
+
+	uint32_t id() const				/**< \return non-zero identifier of the call site */
+	{ return m_id; }
+
+	const char * package_name() const
+	{ return m_package_name; }
+
+	const char * file_name() const
+	{ return m_file_name; }
+
+	int line_number() const
+	{ return m_line_number; }
+
+	const char * function_name() const
+	{ return m_function_name; }
+
+	std::string_view short_function_name() const	/**< \return function name without return type and arguments */
+	{ return m_short_function_name; }
+
+	const char * position( int verbosity ) const	/**< \return the same string as ers::Context::position */
+	{ return m_position[verbosity ? 1 : 0]; }
+
+      private:
+	const char * const	m_package_name;
+	const char * const	m_file_name;
+	const int		m_line_number;
+	const char * const	m_function_name;
+	std::string_view	m_short_function_name;
+	const char *		m_position[2];		/**< \brief position for zero and non-zero verbosity */
+	uint32_t		m_id;
+    };
+}
+
+#endif
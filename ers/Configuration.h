@@ -15,7 +15,13 @@
   * \brief ers header and documentation file
   */
 
+#include <stdint.h>
+
+#include <atomic>
 #include <iostream>
+#include <string>
+
+#include <ers/Severity.h>
 
 namespace ers
 {   
@@ -44,25 +50,106 @@ namespace ers
 	        
   	static Configuration & instance();	/**< \brief return the singleton */
         
-        int debug_level() const			/**< \brief returns current debug level */
-        { return m_debug_level; }
+        int debug_level() const			/**< \brief returns current default debug level */
+        { return m_debug_level.load( std::memory_order_relaxed ); }
+        
+        /** Returns the debug level for the issues of the given class reported by the given package.
+          * The level given for the issue class is used if there is one, otherwise the level of the
+          * package or of the closest enclosing package, e.g. "ros" for "ros.dma", is used.
+          */
+        int debug_level( const char * package_name, const char * issue_class ) const;
         
         int verbosity_level() const		/**< \brief returns current verbosity level */
         { return m_verbosity_level; }
         
-        void debug_level( int debug_level )	/**< \brief can be used to set the current debug level */
-        { m_debug_level = debug_level; }
+        void debug_level( int debug_level );	/**< \brief can be used to set the current default debug level */
+        
+        /** Sets the debug levels for the whole application. The levels are given by a comma separated
+          * list, which contains the default level and the levels for the packages and issue classes, e.g.
+          * "0,ros=3,ros.dma=5,daq::DataLost=2". The names which contain "::" are the issue classes, the
+          * other ones are the package names, which define a hierarchy by the dot separated prefixes.
+          * The levels can also be given by the TDAQ_ERS_DEBUG_LEVEL environment variable.
+          */
+        void debug_level( const std::string & levels );
         
         void verbosity_level( int verbosity_level );	/**< \brief can be used to set the current verbosity level */
         
+        /** Sets the policy which defines for which issues the stack frames are captured.
+          * The policy is a comma separated list of the following tokens:
+          *   - "all" - stack is captured for all issues
+          *   - "none" - stack is never captured
+          *   - "<severity>+", e.g. "error+" - stack is captured for issues of this or higher severity
+          *   - "sample(1/N)" - stack is captured for every N-th issue of any severity in a thread
+          *   - "demand" - stack is captured if one of the streams configured for the issue
+          *     severity prints it, e.g. the verbosity level is higher than 3
+          *
+          * The stack is captured if any of the given conditions is satisfied. The default
+          * policy is "demand", it can be changed with the TDAQ_ERS_STACK environment variable.
+          * The severity of issues created with the ERS_HERE macro is assumed to be ERROR.
+          */
+        void stack_policy( const std::string & policy );
+        
+        static bool stack_wanted( ers::severity severity );	/**< \brief true if stack has to be captured for an issue of the given severity */
+        
       private:	
+	friend class DebugSite;
+
+	struct DebugLevels;
+
 	Configuration( );
+        
+        void set_debug_levels( int default_level, const DebugLevels * levels );
                 
-        int m_debug_level;		/**< \brief current active level for the debug stream */	
+        std::atomic<int> m_debug_level;		/**< \brief current default level for the debug stream */	
+        std::atomic<const DebugLevels *> m_debug_levels;	/**< \brief current levels of packages and issue classes, 0 if there are none */
     	int m_verbosity_level;		/**< \brief current verbosity level for all streams */
+    	std::string m_stack_policy;	/**< \brief current stack capturing policy */
+        
+        static std::atomic<bool>		s_stack_configured;	/**< \brief stack policy has been read from the environment */
+        static std::atomic<int>			s_stack_severity;	/**< \brief stack is captured for this and higher severities */
+        static std::atomic<bool>		s_stack_on_demand;	/**< \brief stack is captured if streams print it */
+        static std::atomic<unsigned int>	s_stack_sampling;	/**< \brief stack is captured for each N-th issue */
+        static std::atomic<uint32_t>		s_debug_epoch;		/**< \brief incremented when the debug levels are changed */
     };
     
     std::ostream & operator<<( std::ostream &, const ers::Configuration & );
+
+    /** This class caches the debug level for a single ERS_DEBUG or ERS_TRACE statement. The level
+      * is resolved when the statement is executed for the first time and after the debug levels are
+      * changed, which is detected by comparing the configuration epoch with the one stored together
+      * with the cached level. The epoch and the level are kept in a single word, so checking the level
+      * costs one comparison. The class has a constexpr constructor, which allows the statements
+      * to declare static instances without the run-time initialisation guard.
+      */
+    class DebugSite
+    {
+      public:
+	constexpr DebugSite( const char * package_name, const char * issue_class )
+	  : m_package_name( package_name ),
+	    m_issue_class( issue_class ),
+	    m_cached( 0 )
+	{ }
+
+	/** \return true if the messages of the given level are enabled for this statement */
+	bool enabled( int level )
+	{
+	    uint64_t epoch = Configuration::s_debug_epoch.load( std::memory_order_relaxed );
+	    uint64_t cached = m_cached.load( std::memory_order_relaxed );
+	    if ( cached >= ( ( epoch << 32 ) | biased( level ) ) )
+		return true;
+	    return ( cached >> 32 ) != epoch && resolve() >= level;
+	}
+
+      private:
+	static uint32_t biased( int level )
+	{ return uint32_t( int64_t( level ) + 0x80000000LL ); }
+
+	int resolve();
+
+	const char * const	m_package_name;
+	const char * const	m_issue_class;
+	std::atomic<uint64_t>	m_cached;	/**< \brief epoch in the upper half and biased level in the lower one */
+    };
 }
 
 #endif
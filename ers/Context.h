@@ -16,11 +16,14 @@
   */ 
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <ers/Configuration.h>
 
 namespace ers
 {   
+    class CallSite;
+
     /** This class provides an abstract interface to access the context of an issue.
       *
       * \author Serguei Kolos
@@ -34,8 +37,26 @@ namespace ers
         
 	std::string position( int verbosity = ers::Configuration::instance().verbosity_level() ) const;		/**< \return position in the code */
 	
+        /**< \return position in the code, the view is valid until the next call of this function in the same thread */
+	std::string_view position_view( int verbosity = ers::Configuration::instance().verbosity_level() ) const;
+	
+	static std::string position(	const char * package_name,
+					const char * file_name,
+					int line_number,
+					const char * function_name,
+					int verbosity );		/**< \return position in the code */
+	
         std::vector<std::string> stack( ) const;		/**< \return stack frames vector */
 	
+        /**< \return stack frames vector, the views are valid until the next call of this function in the same thread */
+        const std::vector<std::string_view> & stack_view( ) const;
+	
+        /**< \brief must be called by the crash handlers before printing the stack frames, after that
+          the symbols cache is not used, so the stack can be printed even if the crashing thread has locked it */
+        static void set_crashing( );
+	
+        static bool is_crashing( );	/**< \return true if set_crashing has been called */
+	
         virtual Context * clone() const = 0;			/**< \return copy of the current context */
         virtual const char * cwd() const = 0;			/**< \return current working directory of the process */
         virtual const char * file_name() const = 0;		/**< \return name of the file which created the issue */
@@ -50,6 +71,8 @@ namespace ers
         virtual int user_id() const = 0;			/**< \return user id */
         virtual const char * user_name() const = 0;		/**< \return user name */
         virtual const char * application_name() const = 0;	/**< \return application name */
+        virtual const CallSite * call_site() const		/**< \return static descriptor of the position in the code or 0 */
+        { return 0; }
     };
 }
 
@@ -15,7 +15,7 @@
 #include <stdio.h>
 #include <string.h>
 
-#include <map>
+#include <atomic>
 #include <string>
 #include <iostream>
 #include <sstream>
@@ -25,6 +25,8 @@
 #include <ers/IssueFactory.h>
 #include <ers/LocalContext.h>
 #include <ers/Severity.h>
+#include <ers/internal/QualifierSet.h>
+#include <ers/internal/StringMap.h>
 
 /** \file Issue.h This file defines the ers::Issue class, 
   * which is the base class for any user defined issue.
@@ -38,8 +40,46 @@ namespace ers
 {
     class OutputStream;
         
-    typedef std::map<std::string, std::string>	string_map;
-    
+    /** Defines how an attribute of a given type is stored in a user defined issue.
+      * Strings given as C pointers are copied to std::string, so that the issue does
+      * not depend on the lifetime of the original character array.
+      */
+    template <class T>
+    struct AttributeTraits
+    {
+	typedef T type;
+
+	static const T & store( const T & value )
+	{ return value; }
+
+	static const T & get( const T & value )
+	{ return value; }
+    };
+
+    template <>
+    struct AttributeTraits<const char *>
+    {
+	typedef std::string type;
+
+	static std::string store( const char * value )
+	{ return value ? value : ""; }
+
+	static const char * get( const std::string & value )
+	{ return value.c_str(); }
+    };
+
+    template <>
+    struct AttributeTraits<char *>
+    {
+	typedef std::string type;
+
+	static std::string store( const char * value )
+	{ return value ? value : ""; }
+
+	static char * get( const std::string & value )
+	{ return const_cast<char *>( value.c_str() ); }
+    };
+
     template<class T>
     class IssueRegistrator {
     public:
@@ -54,8 +94,10 @@ namespace ers
     };
     
     /** This is a base class for any user define issue.
-      *  The class stores all attributes declared in a user define descendant class in a hashmap
-      *  as sting key/value pairs. The object defines a number of methods for providing access to this map.
+      *  The classes declared with the ERS_DECLARE_ISSUE macros keep their attributes in data members of
+      *  the declared types. These attributes are converted to string key/value pairs only when the
+      *  parameters() function is called for the first time, which normally happens when the issue
+      *  is printed or sent to a remote stream. The object defines a number of methods for providing access to this map.
       *  For an example of how to define a custom subclass of the Issue have a look at the SampleIssues.h file.
       *
       *  \see ers::IssueFactory
@@ -89,6 +131,8 @@ namespace ers
 	
 	void add_qualifier( const std::string & qualif );	/**< \brief adds a qualifier to the issue */
 	
+	void add_qualifier( const char * qualif );		/**< \brief adds a qualifier to the issue */
+	
 	const Issue * cause() const				/**< \brief return the cause Issue of this Issue */
 	{ return m_cause.get(); }
         
@@ -101,8 +145,12 @@ namespace ers
 	const std::vector<std::string> & qualifiers() const	/**< \brief return array of qualifiers */
         { return m_qualifiers; }
         
+	const QualifierSet & qualifier_set() const		/**< \brief return symbols of the qualifiers */
+        { return m_qualifier_set; }
+        
 	const string_map & parameters() const                   /**< \brief return array of parameters */
-        { return m_values; }
+        { if ( !m_values_rendered.load( std::memory_order_acquire ) ) render_parameters();
+          return m_values; }
         
         ers::Severity severity() const				/**< \brief severity of the issue */
 	{ return m_severity; }
@@ -138,7 +186,7 @@ namespace ers
 		const ers::Context & context,
 		const std::string & message,
 		const std::vector<std::string> & qualifiers,
-		const std::map<std::string, std::string> & parameters,
+		const string_map & parameters,
 		const ers::Issue * cause = 0 );
         
         /**< \brief Gets a value of any type that has an input operator for the standard stream defined */
@@ -151,6 +199,22 @@ namespace ers
 	template <typename T>
 	void set_value( const std::string & key, T value );
 
+	/**< \brief Converts the value to string and stores it with the given key to the parameters of this issue */
+	template <typename T>
+	void render_value( const char * key, const T & value ) const;
+
+	/**< \brief Converts typed attributes of this issue to strings, must be overridden by the
+	  descendants which call set_typed_values() and call the base class version first */
+	virtual void render_values() const
+	{ ; }
+
+	/**< \brief Declares that this issue keeps its attributes in typed data members */
+	void set_typed_values()
+	{ m_typed_values = true; m_values_rendered.store( false, std::memory_order_relaxed ); }
+
+	bool typed_values() const				/**< \brief true if attributes are kept in typed data members */
+	{ return m_typed_values; }
+
 	void set_message( const std::string & message )
 	{ m_message = message; }
         
@@ -158,14 +222,26 @@ namespace ers
         
       private:        
         Issue & operator=( const Issue & other ) = delete;
+
+	void render_parameters() const;
+
+	void add_default_qualifiers();
+
+	void set_qualifiers( const std::vector<std::string> & qualifiers );
+
+	static std::string format_time( std::time_t t, const std::string & format, bool isUTC,
+					int width, long long fraction );
 					  
 	std::unique_ptr<const Issue>	m_cause;		/**< \brief Issue that caused the current issue */
 	std::unique_ptr<Context>	m_context;		/**< \brief Context of the current issue */
 	std::string			m_message;		/**< \brief Issue's explanation text */
 	std::vector<std::string>	m_qualifiers;		/**< \brief List of associated qualifiers */
+	QualifierSet			m_qualifier_set;	/**< \brief Symbols of the associated qualifiers */
 	mutable Severity		m_severity;		/**< \brief Issue's severity */
 	system_clock::time_point	m_time;			/**< \brief Time when issue was thrown */
-	string_map			m_values;		/**< \brief List of user defined attributes. */	
+	mutable string_map		m_values;		/**< \brief List of user defined attributes. */
+	bool				m_typed_values;		/**< \brief Attributes are kept in typed data members */
+	mutable std::atomic<bool>	m_values_rendered;	/**< \brief m_values contains all the attributes */
     };
 
     std::ostream & operator<<( std::ostream &, const ers::Issue & );    
@@ -182,8 +258,9 @@ template <typename T>
 void 
 ers::Issue::get_value( const std::string & key, T & value ) const
 {
-    string_map::const_iterator it = m_values.find(key);
-    if ( it == m_values.end() )
+    const string_map & values = parameters();
+    string_map::const_iterator it = values.find(key);
+    if ( it == values.end() )
     {
 	throw ers::NoValue( ERS_HERE, key );
     }
@@ -197,7 +274,16 @@ ers::Issue::set_value( const std::string & key, T value )
 {
     std::ostringstream out;
     out << value;
-    m_values[key] = out.str();
+    m_values.insert_or_assign( key, out.str() );
+}
+
+template <typename T>
+void 
+ers::Issue::render_value( const char * key, const T & value ) const
+{
+    std::ostringstream out;
+    out << value;
+    m_values.insert_or_assign( key, out.str() );
 }
 
 template <class Precision>
@@ -207,17 +293,10 @@ ers::Issue::time(const std::string & format, bool isUTC) const
     static const int width(::log10(Precision::period::den));
     
     std::time_t t = time_t();
-    std::tm tm = isUTC ? *gmtime_r(&t, &tm) : *localtime_r(&t, &tm);
-
-    char buff[128];
-    std::strftime(buff, 128 - 16, format.c_str(), &tm);
-
     auto c = std::chrono::duration_cast<Precision>(
 			m_time.time_since_epoch()).count();
-    double frac = c - (double)t*Precision::period::den;
-    sprintf(buff + strlen(buff), ",%0*.0f", width, frac);
 
-    return buff;
+    return format_time( t, format, isUTC, width, c - (long long)t*Precision::period::den );
 }
 
 #endif
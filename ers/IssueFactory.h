@@ -17,6 +17,7 @@
 #include <map>
 
 #include <ers/Severity.h>
+#include <ers/internal/StringMap.h>
 
 /** \file IssueFactory.h This file defines the IssueFactory class, 
   * which is responsible for registration and creation of user defined issues.
@@ -60,7 +61,7 @@ namespace ers
                         const system_clock::time_point & time,
                         const std::string & message,
                         const std::vector<std::string> & qualifiers,
-                        const std::map<std::string, std::string> & parameters,
+                        const string_map & parameters,
                         const Issue * cause = 0 ) const ;			/**< \brief build issue out of all the given parameters */
 	
         void register_issue( const std::string & name, IssueCreator creator );	/**< \brief register an issue factory */
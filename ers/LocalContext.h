@@ -18,6 +18,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <memory>
+
+#include <ers/CallSite.h>
+#include <ers/Configuration.h>
 #include <ers/Context.h>
 
 #ifdef  TDAQ_PACKAGE_NAME
@@ -63,6 +67,13 @@ namespace ers
                         const char * function_name,
                         bool debug = false);
 
+	/** creates a new instance of a local context for an issue.
+	  * This constructor should not be called directly, instead one should use the \c ERS_HERE macro.
+	  * \param site descriptor of the current position in the code
+	  */
+	LocalContext(	const CallSite & site,
+                        bool debug = false);
+
         virtual ~LocalContext()
         { ; }
 
@@ -94,7 +105,7 @@ namespace ers
         { return m_thread_id; }
         
         void * const * stack_symbols() const		/**< \return stack frames */
-        { return m_stack; }
+        { return m_stack.get(); }
         
         int stack_size() const				/**< \return number of frames in stack */
         { return m_stack_size; }
@@ -107,30 +118,47 @@ namespace ers
 
         const char * application_name() const;		/**< \return application name */
 
+        const CallSite * call_site() const		/**< \return descriptor of the position in the code */
+        { return m_call_site; }
+
         static void resetProcessContext();
 
       private:
         static const LocalProcessContext	c_process;
 
+	const CallSite * const			m_call_site;	/**< source position descriptor */
 	const char * const			m_package_name; /**< source package name */
         const char * const			m_file_name;	/**< source file-name */
 	const char * const			m_function_name;/**< source function name */
 	const int				m_line_number;	/**< source line-number */
 	const pid_t				m_thread_id;	/**< thread id */	
-        void *					m_stack[64];	/**< stack frames */
-	const int				m_stack_size;	/**< stack frames number */
+	std::shared_ptr<void *[]>		m_stack;	/**< stack frames, shared by the context copies */
+	int					m_stack_size;	/**< stack frames number */
     };
 }
 
-/** \def ERS_HERE This macro constructs a context object with all the current values 
+/** \def ERS_CALL_SITE This macro returns a reference to the static descriptor of the current position in the code,
+  * which is created when the macro is executed for the first time.
+  * \def ERS_HERE This macro constructs a context object with all the current values.
+  * The stack frames are captured according to the policy defined by ers::Configuration::stack_policy,
+  * assuming that the new issue will be reported with the ERROR severity.
+  * \def ERS_HERE_SEVERITY( severity ) Same as ERS_HERE for an issue which will be reported with the given severity
+  * \def ERS_HERE_DEBUG This macro constructs a context object which always contains the stack frames
   */
-#define ERS_HERE_DEBUG ers::LocalContext( ERS_PACKAGE, __FILE__, __LINE__, __PRETTY_FUNCTION__, true )
+#define ERS_CALL_SITE \
+	( []( const char * __ers_function__ ) -> const ers::CallSite & { \
+		static const ers::CallSite __ers_site__( ERS_PACKAGE, __FILE__, __LINE__, __ers_function__ ); \
+		return __ers_site__; } )( __PRETTY_FUNCTION__ )
+
+#define ERS_HERE_DEBUG ers::LocalContext( ERS_CALL_SITE, true )
 
 #ifndef ERS_NO_DEBUG
-#define ERS_HERE ERS_HERE_DEBUG
+#define ERS_HERE_SEVERITY( severity ) ers::LocalContext( ERS_CALL_SITE, ers::Configuration::stack_wanted( severity ) )
 #else
-#define ERS_HERE ers::LocalContext( ERS_PACKAGE, __FILE__, __LINE__, __PRETTY_FUNCTION__, false)
+#define ERS_HERE_SEVERITY( severity ) ers::LocalContext( ERS_CALL_SITE, false )
 #endif
 
+#define ERS_HERE ERS_HERE_SEVERITY( ers::Error )
+
 #endif
 
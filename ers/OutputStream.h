@@ -46,6 +46,13 @@ namespace ers
 	/**< \brief Sends the issue into this stream */
 	virtual void write( const Issue & issue ) = 0;
 	
+	/**< \brief Delivers all the issues buffered by this stream and its chained streams */
+	virtual void flush( );
+	
+        /**< \brief true if the stream may print stack frames of the issues it receives, the default is true
+          since the stack frames can not be captured later for the streams which use them */
+        virtual bool needsStack() const;
+	
       protected:
         OutputStream( );
                 
@@ -53,6 +60,8 @@ namespace ers
         
         virtual bool isNull() const;
         
+        virtual bool isPassThrough() const;	/**< \brief true if the stream produces no output but only forwards issues to the chained one */
+        
       private:
 	OutputStream( const OutputStream & other ) = delete;
         OutputStream & operator=( const OutputStream & ) = delete;
@@ -12,6 +12,7 @@
 
 #include <initializer_list>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
@@ -34,6 +35,7 @@ namespace ers
     class LocalStream;
     class OutputStream; 
     class ErrorHandler; 
+    class Configuration;
     class Issue;
     class StreamInitializer;
     template <class > class SingletonCreator;
@@ -60,6 +62,7 @@ namespace ers
       friend class StreamInitializer;
       friend class ers::LocalStream;
       friend class ers::ErrorHandler;
+      friend class ers::Configuration;
       template <class > friend class SingletonCreator;
       
       public:
@@ -94,9 +97,27 @@ namespace ers
       
 	void report_issue( ers::severity type, const Issue & issue );
 
+	void flush( );					/**< \brief delivers issues buffered by all output streams */
+
+	/**< \brief returns false if issues of the given severity can never produce any output */
+	static bool is_enabled( ers::severity severity )
+	{ return s_enabled[severity].load( std::memory_order_relaxed ); }
+
+	/**< \brief returns true if any of the streams for the given severity may print stack frames */
+	static bool is_stack_needed( ers::severity severity )
+	{ return s_stack_needed[severity].load( std::memory_order_relaxed ); }
+
       private:	
 	StreamManager( );
 
+	void update_enabled( ers::severity severity );
+	
+	void update_enabled( );
+	
+	static bool is_null( const OutputStream * stream );
+	
+	static bool needs_stack( const OutputStream * stream );
+
 	OutputStream * setup_stream( ers::severity severity );	
 	OutputStream * setup_stream( const std::vector<std::string> & streams );
         
@@ -105,6 +126,9 @@ namespace ers
 	std::list<std::shared_ptr<InputStream> >	m_in_streams;
 	std::shared_ptr<OutputStream>			m_init_streams[ers::Fatal + 1];	/**< \brief array of pointers to streams per severity */
 	std::shared_ptr<OutputStream>			m_out_streams[ers::Fatal + 1];	/**< \brief array of pointers to streams per severity */
+	
+	static std::atomic<bool>			s_enabled[ers::Fatal + 1];	/**< \brief array of output flags per severity */
+	static std::atomic<bool>			s_stack_needed[ers::Fatal + 1];	/**< \brief array of stack printing flags per severity */
     };
     
     std::ostream & operator<<( std::ostream &, const ers::StreamManager & );
@@ -0,0 +1,160 @@
+/*
+ *  Trace.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file Trace.h This file defines the ERS_TRACE macro and the classes used for deferred
+  * formatting of debug messages.
+  * \brief ers header file
+  */
+
+#ifndef ERS_TRACE_H
+#define ERS_TRACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ers
+{
+    /** Describes a single ERS_TRACE statement. An instance of this class is statically
+      * initialised for every statement and is registered with the trace collector
+      * when the statement is executed for the first time.
+      */
+    struct TraceSite
+    {
+	const char *		package;
+	const char *		file;
+	int			line;
+	const char *		function;
+	int			level;
+	std::atomic<uint32_t>	id;		/**< \brief identifier assigned by the collector, 0 if not yet registered */
+    };
+
+    /** Defines how arguments of ERS_TRACE statements are stored in the trace buffers. */
+    struct TraceArgument
+    {
+	enum Type : uint8_t { Signed, Unsigned, Double, String, Pointer };
+    };
+
+    template <class T, class = void>
+    struct TraceArgumentTraits;
+
+    template <class T>
+    struct TraceArgumentTraits<T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>>>
+    {
+	static constexpr uint8_t type = TraceArgument::Signed;
+	static size_t size( T ) { return sizeof( int64_t ); }
+	static char * put( char * p, T value )
+	{ int64_t v = value; memcpy( p, &v, sizeof( v ) ); return p + sizeof( v ); }
+    };
+
+    template <class T>
+    struct TraceArgumentTraits<T, std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T>>>
+    {
+	static constexpr uint8_t type = TraceArgument::Unsigned;
+	static size_t size( T ) { return sizeof( uint64_t ); }
+	static char * put( char * p, T value )
+	{ uint64_t v = value; memcpy( p, &v, sizeof( v ) ); return p + sizeof( v ); }
+    };
+
+    template <class T>
+    struct TraceArgumentTraits<T, std::enable_if_t<std::is_enum_v<T>>>
+	: public TraceArgumentTraits<std::underlying_type_t<T>>
+    {
+	static size_t size( T ) { return sizeof( int64_t ); }
+	static char * put( char * p, T value )
+	{ return TraceArgumentTraits<std::underlying_type_t<T>>::put( p, std::underlying_type_t<T>( value ) ); }
+    };
+
+    template <class T>
+    struct TraceArgumentTraits<T, std::enable_if_t<std::is_floating_point_v<T>>>
+    {
+	static constexpr uint8_t type = TraceArgument::Double;
+	static size_t size( T ) { return sizeof( double ); }
+	static char * put( char * p, T value )
+	{ double v = value; memcpy( p, &v, sizeof( v ) ); return p + sizeof( v ); }
+    };
+
+    template <>
+    struct TraceArgumentTraits<std::string_view>
+    {
+	static constexpr uint8_t type = TraceArgument::String;
+	static size_t size( std::string_view value ) { return sizeof( uint32_t ) + value.size(); }
+	static char * put( char * p, std::string_view value )
+	{
+	    uint32_t size = value.size();
+	    memcpy( p, &size, sizeof( size ) );
+	    memcpy( p + sizeof( size ), value.data(), size );
+	    return p + sizeof( size ) + size;
+	}
+    };
+
+    template <>
+    struct TraceArgumentTraits<std::string> : public TraceArgumentTraits<std::string_view> { };
+
+    template <>
+    struct TraceArgumentTraits<const char *> : public TraceArgumentTraits<std::string_view>
+    {
+	static size_t size( const char * value )
+	{ return TraceArgumentTraits<std::string_view>::size( value ? value : "(null)" ); }
+	static char * put( char * p, const char * value )
+	{ return TraceArgumentTraits<std::string_view>::put( p, value ? value : "(null)" ); }
+    };
+
+    template <>
+    struct TraceArgumentTraits<char *> : public TraceArgumentTraits<const char *> { };
+
+    template <class T>
+    struct TraceArgumentTraits<T *, std::enable_if_t<!std::is_same_v<std::remove_cv_t<T>, char>>>
+    {
+	static constexpr uint8_t type = TraceArgument::Pointer;
+	static size_t size( const T * ) { return sizeof( uint64_t ); }
+	static char * put( char * p, const T * value )
+	{ uint64_t v = reinterpret_cast<uintptr_t>( value ); memcpy( p, &v, sizeof( v ) ); return p + sizeof( v ); }
+    };
+
+    /** Registers the statement described by the given site and the types of its arguments with the trace collector.
+      * \return identifier of the statement
+      */
+    uint32_t trace_register( TraceSite & site, const char * format, std::initializer_list<uint8_t> types );
+
+    /** Reserves a record for the given statement in the trace buffer of the current thread.
+      * \return pointer to the space for the arguments of the given size or 0 if the buffer is full
+      */
+    char * trace_reserve( uint32_t id, size_t arguments_size );
+
+    /** Makes the record reserved by the last trace_reserve call of the current thread visible to the collector. */
+    void trace_commit( size_t arguments_size );
+
+    /** Writes a trace record for the given statement to the buffer of the current thread.
+      * This function should not be called directly, instead one should use the \c ERS_TRACE macro.
+      */
+    template <class ... Args>
+    void trace( TraceSite & site, const char * format, const Args & ... args )
+    {
+	uint32_t id = site.id.load( std::memory_order_acquire );
+	if ( !id )
+	{
+	    id = trace_register( site, format, { TraceArgumentTraits<std::decay_t<Args>>::type ... } );
+	}
+
+	size_t size = ( size_t( 0 ) + ... + TraceArgumentTraits<std::decay_t<Args>>::size( args ) );
+	char * p = trace_reserve( id, size );
+	if ( !p )
+	    return ;
+
+	( ( p = TraceArgumentTraits<std::decay_t<Args>>::put( p, args ) ), ... );
+	trace_commit( size );
+    }
+}
+
+#endif
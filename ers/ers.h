@@ -18,6 +18,7 @@
 #define ERS_ERS_H
 
 #include <sys/resource.h>
+#include <climits>
 #include <functional>
 #include <sstream>
 #include <ers/StreamManager.h>
@@ -26,11 +27,27 @@
 #include <ers/Assertion.h>
 #include <ers/Severity.h>
 #include <ers/LocalStream.h>
+#include <ers/Trace.h>
 
 #include <boost/preprocessor/logical/not.hpp>
 #include <boost/preprocessor/punctuation/comma_if.hpp>
 #include <boost/preprocessor/facilities/is_empty.hpp>
 
+/** \def ERS_MAX_DEBUG_LEVEL This macro defines the highest debug level for which the ERS_DEBUG
+ * macro produces any code. It can be set at compilation time, e.g. -DERS_MAX_DEBUG_LEVEL=1,
+ * to remove the more verbose debug statements from a build. By default there is no limit.
+ */
+#ifndef ERS_MAX_DEBUG_LEVEL
+#define ERS_MAX_DEBUG_LEVEL INT_MAX
+#endif
+
+/** \def ERS_DEBUG_LEVEL_COMPILED( level ) This macro is a constant expression, which is false if the level
+ * is a constant greater than ERS_MAX_DEBUG_LEVEL and true otherwise. It is used by the ERS_DEBUG and ERS_TRACE
+ * macros with if constexpr, so such statements are discarded by the compiler regardless of the optimisation.
+ */
+#define ERS_DEBUG_LEVEL_COMPILED( level ) \
+	( __builtin_constant_p( level ) ? ers::debug_level_compiled( __builtin_constant_p( level ) ? ( level ) : 0 ) : true )
+
 /*! \namespace ers
  *  This is a wrapping namespace for all ERS classes and global functions.
  */
@@ -66,6 +83,13 @@ namespace ers
     inline int debug_level( )
     { return Configuration::instance().debug_level( ); }
     
+    /*! 
+     *  This function checks the given debug level against the ERS_MAX_DEBUG_LEVEL.
+     *  \see ERS_DEBUG_LEVEL_COMPILED
+     */
+    constexpr bool debug_level_compiled( int level )
+    { return level <= ERS_MAX_DEBUG_LEVEL; }
+    
     /*! 
      *  This function sends the issue to the ERS DEBUG stream which corresponds to the given debug level.
      *  \param issue the issue to be reported
@@ -123,40 +147,81 @@ namespace ers
 
 ERS_DECLARE_ISSUE( ers, Message, ERS_EMPTY, ERS_EMPTY )
 
-#define ERS_REPORT_IMPL( stream, issue, message, level ) \
+#define ERS_REPORT_CONTEXT_IMPL( stream, context, issue, message, level ) \
 { \
     std::ostringstream ers_report_impl_out_buffer; \
     ers_report_impl_out_buffer << message; \
-    stream( issue( ERS_HERE, ers_report_impl_out_buffer.str() ) \
+    stream( issue( context, ers_report_impl_out_buffer.str() ) \
 	    BOOST_PP_COMMA_IF( BOOST_PP_NOT( ERS_IS_EMPTY( ERS_EMPTY level ) ) ) level ); \
 }
 
+#define ERS_REPORT_IMPL( stream, issue, message, level ) \
+	ERS_REPORT_CONTEXT_IMPL( stream, ERS_HERE, issue, message, level )
+
 #ifndef ERS_NO_DEBUG
 /** \def ERS_DEBUG( level, message) This macro sends the message to the ers::debug stream
  * if level is less or equal to the TDAQ_ERS_DEBUG_LEVEL, which is equal to 0 by default.
+ * The debug level for the current package is resolved once and is cached by every statement.
+ * The message is neither formatted nor sent if the debug stream is configured to produce no output.
  * \note This macro is defined to empty statement if the \c ERS_NO_DEBUG macro is defined
+ * \note If level is a constant greater than ERS_MAX_DEBUG_LEVEL the statement is discarded at compile time
  */
 #define ERS_DEBUG( level, message ) do { \
-if ( ers::debug_level() >= level ) \
+if constexpr ( ERS_DEBUG_LEVEL_COMPILED( level ) ) \
 { \
-    ERS_REPORT_IMPL( ers::debug, ers::Message, message, level ); \
+    static ers::DebugSite ers_debug_site( ERS_PACKAGE, "ers::Message" ); \
+    if ( ers::debug_level_compiled( level ) \
+	    && ers::StreamManager::is_enabled( ers::Debug ) && ers_debug_site.enabled( level ) ) \
+    { \
+	ERS_REPORT_CONTEXT_IMPL( ers::debug, ERS_HERE_SEVERITY( ers::Debug ), ers::Message, message, level ); \
+    } \
 } } while(0)
 #else
 #define ERS_DEBUG( level, message ) do { } while(0)
 #endif
 
+#ifndef ERS_NO_DEBUG
+/** \def ERS_TRACE( level, format, ... ) This macro sends a debug message with the given level to the
+ * ers::debug stream, like ERS_DEBUG does, but the message is formatted later by a dedicated thread.
+ * The format must be a string literal with printf like conversions, the other arguments can be numbers,
+ * enumerations, pointers, C strings, std::string and std::string_view objects. The calling thread only
+ * copies the arguments and the time to a per-thread buffer, which is much cheaper than building an issue.
+ * The messages are reported with a delay of up to TDAQ_ERS_TRACE_INTERVAL milliseconds (100 by default)
+ * and are lost if the buffer, whose size is given by TDAQ_ERS_TRACE_BUFFER_SIZE (1M by default), is full.
+ * \note This macro is defined to empty statement if the \c ERS_NO_DEBUG macro is defined
+ * \note If level is a constant greater than ERS_MAX_DEBUG_LEVEL the statement is discarded at compile time
+ */
+#define ERS_TRACE( level, ... ) do { \
+if constexpr ( ERS_DEBUG_LEVEL_COMPILED( level ) ) \
+{ \
+    static ers::DebugSite ers_debug_site( ERS_PACKAGE, "ers::Message" ); \
+    if ( ers::debug_level_compiled( level ) \
+	    && ers::StreamManager::is_enabled( ers::Debug ) && ers_debug_site.enabled( level ) ) \
+    { \
+	static ers::TraceSite ers_trace_site = { ERS_PACKAGE, __FILE__, __LINE__, __PRETTY_FUNCTION__, level, {} }; \
+	ers::trace( ers_trace_site, __VA_ARGS__ ); \
+    } \
+} } while(0)
+#else
+#define ERS_TRACE( level, ... ) do { } while(0)
+#endif
+
 /** \def ERS_INFO( message ) This macro sends the message to the ers::info stream.
+ * The message is neither formatted nor sent if the info stream is configured to produce no output.
  */
 #define ERS_INFO( message ) do { \
+if ( ers::StreamManager::is_enabled( ers::Information ) ) \
 { \
-    ERS_REPORT_IMPL( ers::info, ers::Message, message, ERS_EMPTY ); \
+    ERS_REPORT_CONTEXT_IMPL( ers::info, ERS_HERE_SEVERITY( ers::Information ), ers::Message, message, ERS_EMPTY ); \
 } } while(0)
 
 /** \def ERS_LOG( message ) This macro sends the message to the ers::log stream.
+ * The message is neither formatted nor sent if the log stream is configured to produce no output.
  */
 #define ERS_LOG( message ) do { \
+if ( ers::StreamManager::is_enabled( ers::Log ) ) \
 { \
-    ERS_REPORT_IMPL( ers::log, ers::Message, message, ERS_EMPTY ); \
+    ERS_REPORT_CONTEXT_IMPL( ers::log, ERS_HERE_SEVERITY( ers::Log ), ers::Message, message, ERS_EMPTY ); \
 } } while(0)
 
 #endif // ERS_ERS_H
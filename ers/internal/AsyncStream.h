@@ -0,0 +1,88 @@
+/*
+ *  AsyncStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file AsyncStream.h This file defines AsyncStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_ASYNC_STREAM_H
+#define ERS_ASYNC_STREAM_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ers/OutputStream.h>
+
+namespace ers
+{
+    /** This class implements a stream that passes issues to the next streams in the chain
+     * asynchronously. Reported issues are copied to a bounded queue, which is processed by a
+     * dedicated thread, so the reporting thread never waits for the chained streams to complete.
+     * In order to employ this implementation in a stream configuration the name to be used is "async".
+     * E.g. the following configuration will print errors to the standard error stream from a
+     * separate thread:
+     *
+     *         export TDAQ_ERS_ERROR="async(65536),throttle,lstderr"
+     *
+     * This stream has two configuration parameters:
+     *   - first parameter defines the maximum number of issues in the queue, the default is 65536
+     *   - second parameter defines what happens if the queue is full:
+     *       - "drop" - the new issue is discarded (default)
+     *       - "block" - the reporting thread waits until there is space in the queue
+     *       - "drop_low" - issues with severity below WARNING are discarded, the other ones wait
+     *
+     * The number of discarded issues is reported to the chained streams as a separate issue.
+     *
+     * \brief Passes issues to the chained streams from a dedicated thread
+     */
+    class AsyncStream : public OutputStream
+    {
+      public:
+	explicit AsyncStream( const std::string & format );
+
+        ~AsyncStream();
+
+        void write( const Issue & issue ) override;
+
+        void flush( ) override;
+
+        bool isPassThrough() const override
+        { return true; }
+
+        bool needsStack() const override
+        { return false; }
+
+      private:
+	enum Policy { Drop, Block, DropLow };
+
+        bool must_wait( const Issue & issue ) const;
+
+        void run( );
+
+        std::vector<std::unique_ptr<Issue>>	m_queue;		/**< \brief ring buffer of the pending issues */
+        size_t					m_head;
+        size_t					m_size;
+        size_t					m_reserved;		/**< \brief number of free slots claimed by the issues being copied */
+        Policy					m_policy;
+        size_t					m_dropped;		/**< \brief number of discarded issues not yet reported */
+        size_t					m_processed;		/**< \brief number of issues passed to the chained stream */
+        unsigned long				m_flush_requested;
+        unsigned long				m_flush_done;
+        bool					m_terminated;
+        std::mutex				m_mutex;
+        std::condition_variable			m_not_empty;
+        std::condition_variable			m_not_full;
+        std::condition_variable			m_progress;
+        std::thread				m_thread;
+    };
+}
+
+#endif
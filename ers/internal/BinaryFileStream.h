@@ -0,0 +1,52 @@
+/*
+ *  BinaryFileStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file BinaryFileStream.h This file defines BinaryFileStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_BINARY_FILE_STREAM_H
+#define ERS_BINARY_FILE_STREAM_H
+
+#include <string>
+
+#include <ers/OutputStream.h>
+
+namespace ers
+{
+    /** This class implements a stream that writes issues to a file using the binary encoding
+     * defined by the ers::BinaryStreamOutput class. Such files are much smaller than the text ones and can
+     * be converted back to issues without loss of information, e.g. by the ers_decode utility.
+     * In order to employ this implementation in a stream configuration the name to be used is "binfile".
+     * E.g. the following configuration will write errors to the /tmp/errors.ers file:
+     *
+     *         export TDAQ_ERS_ERROR="binfile(/tmp/errors.ers)"
+     *
+     * The file is opened in append mode and each issue is written to it by a single system call,
+     * so several threads and processes can use the same file.
+     *
+     * \brief Writes issues to a file in binary format
+     */
+    class BinaryFileStream : public OutputStream
+    {
+      public:
+	explicit BinaryFileStream( const std::string & file_name );
+
+        ~BinaryFileStream();
+
+        void write( const Issue & issue ) override;
+
+        bool needsStack() const override	/**< \brief the binary encoding does not contain stack frames */
+        { return false; }
+
+      private:
+        int	m_fd;
+    };
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ *  BufferedFileStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file BufferedFileStream.h This file defines BufferedFileStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_BUFFERED_FILE_STREAM_H
+#define ERS_BUFFERED_FILE_STREAM_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <ers/OutputStream.h>
+#include <ers/Severity.h>
+
+namespace ers
+{
+    /** This class implements a stream that prints issues to a file in the same format as the "file" stream,
+     * but collects them in a memory buffer, which is written to the file only when it is full, periodically
+     * or when an issue of high severity is reported. In order to employ this implementation in a stream
+     * configuration the name to be used is "bfile". E.g. the following configuration will print debug
+     * messages to the /tmp/debug.log file, writing them at least every 100 milliseconds:
+     *
+     *         export TDAQ_ERS_DEBUG="bfile(/tmp/debug.log,1M,100)"
+     *
+     * This stream has four configuration parameters:
+     *   - first parameter is the name of the output file, which is opened in append mode
+     *   - second parameter defines the buffer size, K, M and G suffixes can be used, the default is 1M
+     *   - third parameter defines the maximum time in milliseconds for which issues can stay in the buffer,
+     *     the default is 200, 0 disables periodic writing
+     *   - fourth parameter defines the lowest severity of issues that cause the buffer to be written
+     *     immediately, the default is WARNING
+     *
+     * The buffer is also written when the application exits normally or crashes.
+     *
+     * \brief Prints issues to a file using an intermediate memory buffer
+     */
+    class BufferedFileStream : public OutputStream
+    {
+      public:
+	explicit BufferedFileStream( const std::string & format );
+
+        ~BufferedFileStream();
+
+        void write( const Issue & issue ) override;
+
+        void flush( ) override;
+
+        bool needsStack() const override;
+
+      private:
+        bool write_buffer( const std::chrono::milliseconds & timeout );
+
+        void run( );
+
+        int				m_fd;
+        size_t				m_buffer_size;
+        std::chrono::milliseconds	m_flush_interval;
+        ers::severity			m_flush_severity;
+        std::string			m_buffer;		/**< \brief issues which have not been written yet */
+        std::string			m_output;		/**< \brief issues which are being written */
+        std::timed_mutex		m_buffer_mutex;
+        std::timed_mutex		m_output_mutex;		/**< \brief keeps the order of the buffers written to the file */
+        bool				m_terminated;
+        std::mutex			m_timer_mutex;
+        std::condition_variable		m_timer;
+        std::thread			m_thread;
+    };
+}
+
+#endif
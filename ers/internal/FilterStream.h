@@ -17,14 +17,16 @@
 #define ERS_STREAM_FILTER_H
 
 #include <ers/OutputStream.h>
+#include <ers/internal/QualifierSet.h>
 
 namespace ers
 {    
     /** This stream offers basic filtering capability.
       * It hooks up in front of another stream and filters the messages that are passed to it
       * with respect to the given configuration.
-      * Filtering is based on using plain string comparison of the issue's qualifiers with
-      * the given configuration tokens. A stream configuration is composed of the stream name,
+      * Filtering is based on comparison of the issue's qualifiers with the given configuration
+      * tokens. Both are represented by interned symbols, so an issue is checked by a few
+      * integer operations, independently of the length of the lists. A stream configuration is composed of the stream name,
       * that is "filter", followed by brackets with a comma separated list
       * of string tokens, where any token can be preceded by an exclamation mark. For example:
       *  \li filter(internal,test) - this stream will pass messages that have either
@@ -42,11 +44,19 @@ namespace ers
 	
         void write( const Issue & issue ) override;
         
+        bool isPassThrough() const override
+        { return true; }
+
+        bool needsStack() const override
+        { return false; }
+        
       private:	
         bool is_accepted( const ers::Issue & issue );
+
+        bool is_accepted( const QualifierSet & qualifiers ) const;
         
-	std::vector<std::string> m_include;		/**< \brief include list */
-	std::vector<std::string> m_exclude;		/**< \brief exclude list */
+	QualifierSet m_include;		/**< \brief include list */
+	QualifierSet m_exclude;		/**< \brief exclude list */
     };
 }
 
@@ -15,7 +15,11 @@
 #ifndef ERS_FORMATTED_STANDARD_STREAM_H
 #define ERS_FORMATTED_STANDARD_STREAM_H
 
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <string>
+#include <vector>
 
 #include <ers/OutputStream.h>
 
@@ -24,6 +28,10 @@ namespace ers
 
     /** This is a helper class that provides implementation of an output stream that can be used to
      * customise the output format of the streamed issues.
+     * The device is not flushed after every issue. It is flushed immediately for issues of ERROR and
+     * FATAL severities and for any issue written more than FlushInterval after the previous flush,
+     * as well as when the stream is flushed at exit or by the crash handler. Therefore the last lines
+     * of lower severities written before the application hangs may stay in the device buffer.
      * \author Serguei Kolos
      */
     namespace format
@@ -53,8 +61,23 @@ namespace ers
         
         void write( const Issue & issue ) override;
         
+        void flush( ) override;
+        
+        bool needsStack() const override;
+        
       private:
-	void report( std::ostream & out, const Issue & issue );
+	/** A step of the output plan, which is built from the stream format.
+	  * For every step the literal text is printed first, followed by the issue field.
+	  */
+	struct Step
+	{
+	    std::string		literal;
+	    format::Token	token;
+	};
+
+	void report( std::string & out, const Issue & issue ) const;
+        
+	static const char * prefix( format::Token token );
         
 	struct Fields : public std::map< std::string, format::Token >
         {
@@ -66,6 +89,9 @@ namespace ers
                 
         static Fields			s_supported_fields;
         std::vector<format::Token>	m_tokens;
+        std::vector<Step>		m_plan;
+        std::string			m_tail;		/**< \brief literal text printed after the last field */
+        std::atomic<int64_t>		m_last_flush{ 0 };	/**< \brief time of the last flush in steady clock ticks */
     };
 }
 
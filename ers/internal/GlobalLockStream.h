@@ -33,6 +33,12 @@ namespace ers
     {
 	void write( const Issue & issue ) override;
         
+        bool isPassThrough() const override
+        { return true; }
+
+        bool needsStack() const override
+        { return false; }
+        
       private:
 	static std::mutex mutex_;
     };
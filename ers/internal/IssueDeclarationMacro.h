@@ -28,17 +28,34 @@
 	, ERS_TYPE(tuple) \
 	ERS_NAME(tuple)
 
+#define ERS_ATTRIBUTE_MEMBER_NAME( tuple ) \
+	BOOST_PP_CAT( m_value_, ERS_NAME(tuple) )
+
+#define ERS_ATTRIBUTE_MEMBER( _, __, tuple ) \
+	ers::AttributeTraits<ERS_TYPE(tuple)>::type ERS_ATTRIBUTE_MEMBER_NAME(tuple);
+
+#define ERS_ATTRIBUTE_INITIALIZATION( _, __, tuple ) \
+	, ERS_ATTRIBUTE_MEMBER_NAME(tuple)( ers::AttributeTraits<ERS_TYPE(tuple)>::store( ERS_NAME(tuple) ) )
+
 #define ERS_ATTRIBUTE_SERIALIZATION( _, __, tuple ) \
-	set_value( BOOST_PP_STRINGIZE(ERS_NAME(tuple)), \
-	ERS_NAME(tuple) );
+	render_value( BOOST_PP_STRINGIZE(ERS_NAME(tuple)), \
+	ERS_ATTRIBUTE_MEMBER_NAME(tuple) );
 
 #define ERS_ATTRIBUTE_ACCESSORS( _, __, tuple ) \
 	ERS_TYPE(tuple) \
 	BOOST_PP_CAT( get_, ERS_NAME(tuple) ) () { \
+		if ( typed_values() ) \
+		    return ers::AttributeTraits<ERS_TYPE(tuple)>::get( ERS_ATTRIBUTE_MEMBER_NAME(tuple) ); \
 		ERS_TYPE(tuple) val; \
 		ers::Issue::get_value( BOOST_PP_STRINGIZE(ERS_NAME(tuple)), val ); \
 		return val; \
 	}
+
+#define ERS_HAS_ATTRIBUTES( attributes ) \
+	BOOST_PP_NOT_EQUAL( BOOST_PP_SEQ_SIZE( attributes ), 0 )
+
+#define ERS_SET_TYPED_VALUES( attributes ) \
+	BOOST_PP_EXPR_IF( ERS_HAS_ATTRIBUTES( attributes ), set_typed_values(); )
                                                                 
 #define ERS_SET_MESSAGE( message ) \
 	std::ostringstream out;\
@@ -77,6 +94,13 @@ namespace namespace_name { \
 	const char * get_class_name() const { return get_uid(); } \
 	base_class_name * clone() const { return new namespace_name::class_name( *this ); } \
 	ERS_PRINT_LIST( ERS_ATTRIBUTE_ACCESSORS, ERS_EMPTY attributes ) \
+      protected: \
+	BOOST_PP_EXPR_IF( ERS_HAS_ATTRIBUTES( ERS_EMPTY attributes ), \
+		void render_values() const override { \
+		    base_class_name::render_values(); \
+		    ERS_PRINT_LIST( ERS_ATTRIBUTE_SERIALIZATION, ERS_EMPTY attributes ) } ) \
+      private: \
+	ERS_PRINT_LIST( ERS_ATTRIBUTE_MEMBER, ERS_EMPTY attributes ) \
     }; \
 }
 
@@ -86,8 +110,9 @@ namespace namespace_name { \
 		ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME_TYPE, ERS_EMPTY base_attributes ) \
 		ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME_TYPE, ERS_EMPTY attributes ) ) \
       : base_class_name( context ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME, ERS_EMPTY base_attributes ) ) \
+	ERS_PRINT_LIST( ERS_ATTRIBUTE_INITIALIZATION, ERS_EMPTY attributes ) \
     { \
-      ERS_PRINT_LIST( ERS_ATTRIBUTE_SERIALIZATION, ERS_EMPTY attributes ) \
+      ERS_SET_TYPED_VALUES( ERS_EMPTY attributes ) \
       BOOST_PP_EXPR_IF( BOOST_PP_NOT( ERS_IS_EMPTY( ERS_EMPTY message ) ), ERS_SET_MESSAGE( ERS_EMPTY message ) )\
     } \
     \
@@ -96,8 +121,9 @@ namespace namespace_name { \
 		ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME_TYPE, ERS_EMPTY base_attributes ) \
 		ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME_TYPE, ERS_EMPTY attributes ) ) \
       : base_class_name( context, msg ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME, ERS_EMPTY base_attributes ) ) \
+	ERS_PRINT_LIST( ERS_ATTRIBUTE_INITIALIZATION, ERS_EMPTY attributes ) \
     { \
-      ERS_PRINT_LIST( ERS_ATTRIBUTE_SERIALIZATION, ERS_EMPTY attributes ) \
+      ERS_SET_TYPED_VALUES( ERS_EMPTY attributes ) \
     } \
     \
     INLINE class_name::class_name( const ers::Context & context, \
@@ -106,16 +132,18 @@ namespace namespace_name { \
 		ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME_TYPE, ERS_EMPTY attributes ), \
 		const std::exception & cause ) \
       : base_class_name( context, msg ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME, ERS_EMPTY base_attributes ), cause ) \
+	ERS_PRINT_LIST( ERS_ATTRIBUTE_INITIALIZATION, ERS_EMPTY attributes ) \
     { \
-      ERS_PRINT_LIST( ERS_ATTRIBUTE_SERIALIZATION, ERS_EMPTY attributes ) \
+      ERS_SET_TYPED_VALUES( ERS_EMPTY attributes ) \
     } \
     INLINE class_name::class_name( const ers::Context & context \
 		ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME_TYPE, ERS_EMPTY base_attributes ) \
 		ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME_TYPE, ERS_EMPTY attributes ), \
 		const std::exception & cause ) \
       : base_class_name( context ERS_PRINT_LIST( ERS_ATTRIBUTE_NAME, ERS_EMPTY base_attributes ), cause ) \
+	ERS_PRINT_LIST( ERS_ATTRIBUTE_INITIALIZATION, ERS_EMPTY attributes ) \
     { \
-      ERS_PRINT_LIST( ERS_ATTRIBUTE_SERIALIZATION, ERS_EMPTY attributes ) \
+      ERS_SET_TYPED_VALUES( ERS_EMPTY attributes ) \
       BOOST_PP_EXPR_IF( BOOST_PP_NOT( ERS_IS_EMPTY( ERS_EMPTY message ) ), ERS_SET_MESSAGE( ERS_EMPTY message ) )\
     } \
 } \
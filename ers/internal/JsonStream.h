@@ -0,0 +1,58 @@
+/*
+ *  JsonStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file JsonStream.h This file defines JsonStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_JSON_STREAM_H
+#define ERS_JSON_STREAM_H
+
+#include <string>
+#include <vector>
+
+#include <ers/OutputStream.h>
+
+namespace ers
+{
+    /** This class implements a stream that prints every issue as a single line containing a JSON object.
+     * In order to employ this implementation in a stream configuration the name to be used is "jsonl".
+     * The first parameter defines the output, which can be "stdout", "stderr" or a file name. The other
+     * parameters define the fields of the JSON object and their order. E.g. the following configuration
+     * will print errors to the /tmp/errors.json file, giving only their time, severity, message and the
+     * chain of causes:
+     *
+     *         export TDAQ_ERS_ERROR="jsonl(/tmp/errors.json,time,severity,message,cause)"
+     *
+     * The following fields are supported: time, severity, class, message, application, host, pid, tid,
+     * user, uid, cwd, package, file, line, function, qualifiers, parameters, stack and cause. The cause
+     * object has the same fields as the issue itself. If no fields are given, all of them except stack are printed.
+     *
+     * \brief Prints issues as JSON objects, one per line
+     */
+    class JsonStream : public OutputStream
+    {
+      public:
+	explicit JsonStream( const std::string & format );
+
+        ~JsonStream();
+
+        void write( const Issue & issue ) override;
+
+        bool needsStack() const override;
+
+      private:
+        void print( std::string & out, const Issue & issue ) const;
+
+        std::vector<int>	m_fields;	/**< \brief fields to be printed */
+        int			m_fd;
+        bool			m_close;	/**< \brief the stream has opened the output file */
+    };
+}
+
+#endif
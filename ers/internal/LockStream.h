@@ -37,6 +37,12 @@ namespace ers
     {
 	void write( const Issue & issue ) override;
         
+        bool isPassThrough() const override
+        { return true; }
+
+        bool needsStack() const override
+        { return false; }
+        
       private:
 	std::mutex m_mutex;
     };
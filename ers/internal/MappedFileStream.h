@@ -0,0 +1,100 @@
+/*
+ *  MappedFileStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file MappedFileStream.h This file defines MappedFileStream ERS stream and the layout of the files it writes.
+  * \brief ers header file
+  */
+
+#ifndef ERS_MAPPED_FILE_STREAM_H
+#define ERS_MAPPED_FILE_STREAM_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+#include <ers/OutputStream.h>
+
+namespace ers
+{
+    /** Header of a file written by the MappedFileStream. The header is followed by a sequence of
+      * records, each of them starting at an 8 bytes aligned offset with a MappedRecordHeader.
+      * The space after the last record is filled with zeros, so the record which follows it has
+      * zero size. The records can be found by following their sizes from the data offset.
+      */
+    struct MappedFileHeader
+    {
+	static constexpr char Magic[8] = { 'E', 'R', 'S', 'M', 'M', 'A', 'P', '1' };
+
+	char			magic[8];
+	uint64_t		capacity;	/**< \brief size of the file */
+	uint64_t		data_offset;	/**< \brief offset of the first record */
+	std::atomic<uint64_t>	tail;		/**< \brief offset of the last record or of the first free space */
+	std::atomic<uint64_t>	dropped;	/**< \brief number of issues which did not fit into the file */
+    };
+
+    /** Header of a single record. A record is reserved by setting its size from zero to the size of
+      * its text with a single atomic operation, so the size of every reserved record is known. A record
+      * which is not in the Committed state has not been completely written, e.g. because the application
+      * crashed while writing it. The Padding record has the PaddingSize size and marks the rest of the
+      * file as unused.
+      */
+    struct MappedRecordHeader
+    {
+	enum State : uint32_t { Reserved = 0, Committed = 1, Padding = 2 };
+
+	static constexpr uint32_t PaddingSize = UINT32_MAX;
+
+	std::atomic<uint32_t>	size;		/**< \brief size of the text following the header, zero for free space */
+	std::atomic<uint32_t>	state;
+
+	static uint64_t record_size( uint64_t size )	/**< \brief space occupied by a record with the text of the given size */
+	{ return ( sizeof( MappedRecordHeader ) + size + 7 ) & ~uint64_t( 7 ); }
+    };
+
+    /** This class implements a stream that prints issues in the same format as the "file" stream to a
+     * preallocated memory mapped file. Reporting threads reserve space in the file with a single atomic
+     * operation and copy the issue text directly to the mapped memory, so neither system calls nor locks
+     * are used for reporting an issue. The data is kept by the operating system, so it survives a crash
+     * of the application. In order to employ this implementation in a stream configuration the name to be
+     * used is "mmapfile". E.g. the following configuration will print debug messages to the /tmp/debug.mmap file:
+     *
+     *         export TDAQ_ERS_DEBUG="mmapfile(/tmp/debug.mmap,256M)"
+     *
+     * This stream has two configuration parameters:
+     *   - first parameter is the name of the output file, which is recreated by the stream,
+     *     the existing file is renamed to the same name with the ".1" suffix
+     *   - second parameter defines the file size, K, M and G suffixes can be used, the default is 64M
+     *
+     * Issues which do not fit into the remaining space of the file are dropped and counted in the file header.
+     * The ers_read_mmapfile utility prints the content of such a file as text.
+     *
+     * \brief Prints issues to a memory mapped file
+     */
+    class MappedFileStream : public OutputStream
+    {
+      public:
+	explicit MappedFileStream( const std::string & format );
+
+        ~MappedFileStream();
+
+        void write( const Issue & issue ) override;
+
+        bool needsStack() const override;
+
+      private:
+        MappedRecordHeader * reserve( uint32_t text_size );
+
+        int			m_fd;
+        size_t			m_capacity;
+        char *			m_data;
+        MappedFileHeader *	m_header;
+    };
+}
+
+#endif
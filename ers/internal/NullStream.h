@@ -39,6 +39,9 @@ namespace ers
 
         bool isNull() const override
         { return true; }
+
+        bool needsStack() const override
+        { return false; }
     };
 }
 
@@ -0,0 +1,136 @@
+/*
+ *  QualifierSet.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file QualifierSet.h This file defines the container used for matching issue qualifiers.
+  * \brief ers header file
+  */
+
+#ifndef ERS_QUALIFIER_SET_H
+#define ERS_QUALIFIER_SET_H
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace ers
+{
+    /** This class implements a set of qualifiers, which are represented by integer symbols.
+      * Every qualifier string is mapped to a unique symbol by a process wide table when it is
+      * used for the first time, the mapping is never changed afterwards. The first 64 symbols
+      * are kept in a bit mask, the others in a sorted vector, so for a typical application
+      * checking if two sets have common qualifiers costs a single integer operation.
+      * The table grows with every distinct qualifier added to a local issue or used by a filter, which
+      * are normally given by the code and the configuration. The qualifiers of the issues received from
+      * other processes are only looked up, so they can not make the table grow. If some of them are not
+      * in the table the set is marked as incomplete and the qualifier strings have to be used for matching.
+      *
+      * \brief Set of interned qualifiers.
+      */
+    class QualifierSet
+    {
+      public:
+	typedef uint32_t Symbol;
+
+	static const Symbol NoSymbol = ~Symbol( 0 );
+
+	/** \return symbol of the given qualifier, the qualifier is added to the table if necessary */
+	static Symbol symbol( const char * qualifier );
+
+	static Symbol symbol( const std::string & qualifier )
+	{ return symbol( qualifier.c_str() ); }
+
+	/** \return symbol of the given qualifier or NoSymbol if it is not in the table */
+	static Symbol find( const std::string & qualifier );
+
+	QualifierSet()
+	  : m_mask( 0 ),
+	    m_incomplete( false )
+	{ ; }
+
+	/** \return \c true if the symbol has been added, \c false if it was already in the set */
+	bool insert( Symbol symbol )
+	{
+	    if ( symbol < MaskBits )
+	    {
+		uint64_t bit = uint64_t( 1 ) << symbol;
+		if ( m_mask & bit )
+		    return false;
+		m_mask |= bit;
+		return true;
+	    }
+	    std::vector<Symbol>::iterator it = std::lower_bound( m_symbols.begin(), m_symbols.end(), symbol );
+	    if ( it != m_symbols.end() && *it == symbol )
+		return false;
+	    m_symbols.insert( it, symbol );
+	    return true;
+	}
+
+	bool contains( Symbol symbol ) const
+	{
+	    if ( symbol < MaskBits )
+		return m_mask & ( uint64_t( 1 ) << symbol );
+	    return std::binary_search( m_symbols.begin(), m_symbols.end(), symbol );
+	}
+
+	/** \return \c true if the two sets have at least one common qualifier */
+	bool intersects( const QualifierSet & other ) const
+	{
+	    if ( m_mask & other.m_mask )
+		return true;
+	    if ( m_symbols.empty() || other.m_symbols.empty() )
+		return false;
+	    std::vector<Symbol>::const_iterator it = m_symbols.begin();
+	    std::vector<Symbol>::const_iterator oit = other.m_symbols.begin();
+	    while ( it != m_symbols.end() && oit != other.m_symbols.end() )
+	    {
+		if ( *it == *oit )
+		    return true;
+		*it < *oit ? ++it : ++oit;
+	    }
+	    return false;
+	}
+
+	bool empty() const
+	{ return !m_mask && m_symbols.empty() && !m_incomplete; }
+
+	/** \return \c true if some qualifiers have no symbols, so they are not in this set */
+	bool incomplete() const
+	{ return m_incomplete; }
+
+	void set_incomplete()
+	{ m_incomplete = true; }
+
+	bool operator==( const QualifierSet & other ) const
+	{ return m_mask == other.m_mask && m_symbols == other.m_symbols && m_incomplete == other.m_incomplete; }
+
+	bool operator!=( const QualifierSet & other ) const
+	{ return !( *this == other ); }
+
+	size_t hash() const
+	{
+	    uint64_t h = m_mask;
+	    for ( std::vector<Symbol>::const_iterator it = m_symbols.begin(); it != m_symbols.end(); ++it )
+		h = h * 0x9E3779B97F4A7C15ULL + *it;
+	    return h ^ ( h >> 32 );
+	}
+
+	void clear()
+	{ m_mask = 0; m_symbols.clear(); m_incomplete = false; }
+
+      private:
+	static const Symbol MaskBits = 64;
+
+	uint64_t		m_mask;		/**< \brief symbols smaller than MaskBits */
+	std::vector<Symbol>	m_symbols;	/**< \brief sorted list of the other symbols */
+	bool			m_incomplete;	/**< \brief some qualifiers are not in the table */
+    };
+}
+
+#endif
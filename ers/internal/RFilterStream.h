@@ -15,7 +15,12 @@
 #ifndef ERS_STREAM_RFILTER_H 
 #define ERS_STREAM_RFILTER_H
 
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include <ers/OutputStream.h>
+#include <ers/internal/QualifierSet.h>
 #include <boost/regex.hpp>
 
 namespace ers
@@ -33,6 +38,13 @@ namespace ers
       *  \li rfilter(!create.*,!new.*) - this stream will pass messages that have originated
       *         from a function that starts with neither "create" nor "new" string.
       *
+      * The expressions of each list are combined into a single alternation, so the function name
+      * and every qualifier are searched once per list. Expressions with back references can not be
+      * combined and are evaluated separately. The function name and the qualifiers of the issues
+      * reported from the same place in the code are normally the same, therefore the results are
+      * kept in a bounded cache keyed by the call site, or the function name for the issues which
+      * have no call site descriptor, and the set of qualifiers.
+      *
       * \brief Filtering stream implementation.
       */
     
@@ -43,11 +55,50 @@ namespace ers
 	
         void write( const Issue & issue ) override;
         
+        bool isPassThrough() const override
+        { return true; }
+
+        bool needsStack() const override
+        { return false; }
+        
       private:	    
+        /** Matches a list of regular expressions in a single search if possible. */
+        struct Matcher
+        {
+            void compile( const std::vector<std::string> & patterns );
+
+            bool search( const char * begin, const char * end ) const;
+
+            bool m_empty = true;
+            boost::regex m_combined;                    /**< \brief alternation of the expressions */
+            std::vector<boost::regex> m_separate;       /**< \brief expressions which can not be combined */
+        };
+
+        struct Verdict
+        {
+            uint32_t m_site = 0;                        /**< \brief call site identifier, 0 if the function name is used */
+            std::string m_function;
+            QualifierSet m_qualifiers;
+            bool m_valid = false;
+            bool m_accepted = false;
+        };
+
+        static const size_t ShardBits = 4;
+        static const size_t ShardSize = 16;             /**< \brief number of cached verdicts per shard */
+
+        struct Shard
+        {
+            std::mutex m_mutex;
+            Verdict m_verdicts[ShardSize];
+        };
+
         bool is_accepted( const ers::Issue & issue );
 
-        std::vector<boost::regex> m_regInclude;         /**< \brief include list */
-        std::vector<boost::regex> m_regExclude;         /**< \brief exclude list */
+        bool evaluate( const char * function, const char * function_end, const ers::Issue & issue ) const;
+
+        Matcher m_regInclude;                           /**< \brief include list */
+        Matcher m_regExclude;                           /**< \brief exclude list */
+        Shard m_shards[1 << ShardBits];                 /**< \brief cache of the recent verdicts */
     };
 }
 
@@ -0,0 +1,93 @@
+/*
+ *  RotatingFileStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file RotatingFileStream.h This file defines RotatingFileStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_ROTATING_FILE_STREAM_H
+#define ERS_ROTATING_FILE_STREAM_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <ers/OutputStream.h>
+
+namespace ers
+{
+    /** This class implements a stream that prints issues to a file in the same format as the "file" stream
+     * and switches to a new file when the current one becomes too big or too old. In order to employ this
+     * implementation in a stream configuration the name to be used is "rfile". E.g. the following configuration
+     * will start a new log file every hour or when the current one reaches 256 megabytes and will keep
+     * 10 old files:
+     *
+     *         export TDAQ_ERS_LOG="rfile(/tmp/app.log,256M,10,1h)"
+     *
+     * This stream has four configuration parameters:
+     *   - first parameter is the name of the output file, which is opened in append mode
+     *   - second parameter defines the maximum file size, K, M and G suffixes can be used, the default is 256M,
+     *     0 disables size based rotation
+     *   - third parameter defines the number of old files to keep, the default is 10
+     *   - fourth parameter defines the maximum file age, s, m, h and d suffixes can be used, the default is 0,
+     *     which disables time based rotation
+     *
+     * On rotation the current file is renamed to <name>.<N>, where N is a sequence number, and a new file
+     * is opened. Renamed files are compressed to <name>.<N>.gz by a background thread, which also removes
+     * the oldest ones. Files which were not compressed before the application exited are compressed
+     * when the stream is created again.
+     *
+     * \brief Prints issues to a file which is rotated by size and age
+     */
+    class RotatingFileStream : public OutputStream
+    {
+      public:
+	explicit RotatingFileStream( const std::string & format );
+
+        ~RotatingFileStream();
+
+        void write( const Issue & issue ) override;
+
+        bool needsStack() const override;
+
+      private:
+        void start_file( );
+
+        int rotate( );
+
+        void scan( );
+
+        void compress( unsigned long sequence );
+
+        void remove_old( );
+
+        std::string segment_name( unsigned long sequence ) const;
+
+        void run( );
+
+        std::string				m_file_name;
+        size_t					m_max_size;
+        size_t					m_keep;
+        std::chrono::seconds			m_max_age;
+        int					m_fd;
+        size_t					m_size;			/**< \brief size of the current file */
+        std::chrono::steady_clock::time_point	m_deadline;		/**< \brief time when the current file becomes too old */
+        unsigned long				m_sequence;		/**< \brief sequence number of the last segment */
+        std::mutex				m_mutex;		/**< \brief protects the current file */
+        std::deque<unsigned long>		m_pending;		/**< \brief segments to be compressed */
+        bool					m_terminated;
+        std::mutex				m_compressor_mutex;
+        std::condition_variable			m_compressor_condition;
+        std::thread				m_thread;
+    };
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ *  StagedStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file StagedStream.h This file defines StagedStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_STAGED_STREAM_H
+#define ERS_STAGED_STREAM_H
+
+#include <string>
+
+#include <ers/OutputStream.h>
+
+namespace ers
+{
+    class StagedWriter;
+
+    /** This class implements a stream that prints issues in the same format as the "lstdout", "lstderr"
+     * and "lfile" streams, but without a lock shared by the reporting threads. Every thread renders issues
+     * into its own staging buffer, the buffers are read by a single writer thread, which merges the lines
+     * by the issues time and writes them to the output. In order to employ this implementation in a stream
+     * configuration the names to be used are "sstdout", "sstderr" and "sfile". E.g. the following configuration
+     * will print debug messages to the standard output, delaying them by at most 20 milliseconds:
+     *
+     *         export TDAQ_ERS_DEBUG="sstdout(20)"
+     *
+     * The "sfile" stream takes the name of the output file, which is opened in append mode, as the first
+     * parameter, the other parameters are the same for all the three streams:
+     *   - first parameter defines the time in milliseconds for which lines are kept by the writer in order
+     *     to put them in the right order with the lines coming from the other threads, the default is 50
+     *   - second parameter defines the size of the staging buffer of every thread, K and M suffixes can be
+     *     used, the default is 256K. If the buffer of a thread is full the new issues are discarded without
+     *     waiting for the writer and their number is reported later.
+     *
+     * All the streams which write to the same output share the same writer, which is configured by the
+     * first of them. The lines which have not been written yet are written without delay when the streams
+     * are flushed, e.g. when the application exits or crashes. The writer threads are stopped when the
+     * application exits normally.
+     *
+     * \brief Prints issues from all threads in the time order without a shared lock
+     */
+    class StagedStream : public OutputStream
+    {
+      public:
+	explicit StagedStream( const std::string & format );
+
+	StagedStream( int fd, const std::string & format );
+
+        void write( const Issue & issue ) override;
+
+        void flush( ) override;
+
+        bool needsStack() const override;
+
+      private:
+        StagedWriter &	m_writer;
+    };
+}
+
+#endif
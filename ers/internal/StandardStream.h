@@ -15,11 +15,41 @@
 #ifndef ERS_STANDARD_STREAM_H
 #define ERS_STANDARD_STREAM_H
 
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include <ers/Configuration.h>
 #include <ers/OutputStream.h>
 #include <ers/StandardStreamOutput.h>
 
 namespace ers
 {
+    /** Stream buffer which appends all the output to a string.
+      */
+    struct StringStreamBuffer : public std::streambuf
+    {
+	explicit StringStreamBuffer( std::string & out )
+	  : m_out( out )
+	{ ; }
+
+      protected:
+	int_type overflow( int_type c ) override
+	{
+	    if ( !traits_type::eq_int_type( c, traits_type::eof() ) )
+		m_out.push_back( traits_type::to_char_type( c ) );
+	    return c;
+	}
+
+	std::streamsize xsputn( const char * s, std::streamsize n ) override
+	{
+	    m_out.append( s, n );
+	    return n;
+	}
+
+      private:
+	std::string & m_out;
+    };
 
     /** This class streams an issue into standard C++ output stream.
      *
@@ -41,11 +71,38 @@ namespace ers
           : Device ( file_name )
         { ; }
         
+        /** The issue is rendered into a thread-local buffer, which is then passed
+          * to the device with a single write.
+          */
         void write( const Issue & issue )
 	{
-	    println( device().stream(), issue, Configuration::instance().verbosity_level() );
+	    thread_local std::string buffer;
+	    thread_local StringStreamBuffer buffer_stream( buffer );
+	    thread_local std::ostream out( &buffer_stream );
+
+	    buffer.clear();
+	    out.clear();
+	    println( out, issue, Configuration::instance().verbosity_level() );
+
+	    {
+		auto && d = device();
+		d.write( buffer.data(), buffer.size() );
+		d.flush();
+	    }
 	    chained().write( issue );
 	}
+
+        /** Calls the flush function of the device type directly, which never waits
+          * for the device lock, as this function may be called from a crash handler.
+          */
+        void flush( ) override
+        {
+            Device::flush();
+            chained().flush();
+        }
+
+	bool needsStack() const override
+	{ return Configuration::instance().verbosity_level() > 3; }
     };
 }
     
@@ -0,0 +1,56 @@
+/*
+ *  StringMap.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file StringMap.h This file defines the container used for storing issue attributes.
+  * \brief ers header file
+  */
+
+#ifndef ERS_STRING_MAP_H
+#define ERS_STRING_MAP_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
+
+namespace ers
+{
+    /** This class implements a sorted key/value container for the issue attributes.
+      * The elements are kept in a contiguous vector, which has space for a few elements
+      * inside the container itself. As most of the issues have less than five attributes
+      * building or copying such an issue does not allocate memory for the container.
+      * The interface is the one of std::map, the only difference being that inserting
+      * new elements invalidates iterators and references to the existing ones.
+      *
+      * \brief Key/value container for the issue attributes.
+      */
+    class string_map : public boost::container::flat_map<
+					std::string, std::string, std::less<>,
+					boost::container::small_vector<std::pair<std::string, std::string>, 4> >
+    {
+	typedef boost::container::flat_map<
+					std::string, std::string, std::less<>,
+					boost::container::small_vector<std::pair<std::string, std::string>, 4> > Base;
+      public:
+	using Base::Base;
+
+	string_map() = default;
+
+	/** Converts standard map into the string_map. Kept for compatibility with the code
+	  * which uses std::map for passing issue attributes to ERS.
+	  */
+	string_map( const std::map<std::string, std::string> & map )
+	  : Base( boost::container::ordered_unique_range, map.begin(), map.end() )
+	{ ; }
+    };
+}
+
+#endif
@@ -10,9 +10,15 @@
 #ifndef ERS_THROTTLE_STREAM_H
 #define ERS_THROTTLE_STREAM_H
 
-#include <map>
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <mutex>
+#include <vector>
 
+#include <ers/Issue.h>
 #include <ers/OutputStream.h>
 
 namespace ers
@@ -23,10 +29,34 @@ namespace ers
      *
      *         export TDAQ_ERS_FATAL="throttle(10, 20),stdout"
      *
-     * This stream has two configuration parameters:
+     * This stream has four configuration parameters:
      *   - first parameter defines an initial number of identical messages after which the throttling shall be started
      *   - second parameter defines a timeout in seconds after which the throttling is reset to its initial state if no
      *          issues of a given type have been reported in this period
+     *   - third parameter defines the maximum number of issue types for which the throttling state is kept, the default
+     *          is 10000. If this number is reached the state of the least recently reported issue types is discarded.
+     *   - fourth parameter defines a timeout in seconds after which the state of an issue type which has not been reported
+     *          is discarded, the default is 600. It can not be shorter than the second parameter.
+     *
+     * When the state of an issue type is discarded the number of its suppressed issues is reported. The first time
+     * the maximum number of issue types is reached it is reported to the standard output, since the throttling of
+     * the discarded types starts again from the initial state.
+     *
+     * Alternatively the stream can limit the rate of issues using token buckets, which is selected by giving the
+     * parameters as name=value pairs:
+     *
+     *         export TDAQ_ERS_ERROR="throttle(rate=10/s,burst=30,global=1000/s),lstderr"
+     *
+     *   - rate defines the sustained rate of issues of the same type, the default is 10/s. The rate is given as
+     *          a number of issues per time unit, which can be ms, s, m (minute) or h, the default unit is s
+     *   - burst defines the number of issues of the same type which can pass at once, the default is 30
+     *   - global defines the maximum rate of all the issues passing through the stream, there is no limit by default
+     *   - global_burst defines the number of issues which can pass the global limit at once, the default is the
+     *          number of issues allowed by the global rate in one second
+     *   - max and idle are the maximum number of issue types and the idle timeout as described above
+     *
+     * The rates are checked with nanosecond resolution using the time of the issues. When an issue of a type which
+     * has been suppressed passes the limits it is reported together with the number of the suppressed issues.
      *
      * \author Serguei Kolos
      * \brief Throws issues as exceptions
@@ -37,31 +67,93 @@ namespace ers
 
         void write(const ers::Issue &issue) override;
 
+        bool isPassThrough() const override {
+            return true;
+        }
+
+        bool needsStack() const override {
+            return false;
+        }
+
+        /** \return number of the issue type records which have been discarded because they were idle */
+        size_t expiredRecords() const {
+            return m_expired.load(std::memory_order_relaxed);
+        }
+
+        /** \return number of the issue type records which have been discarded because the table was full */
+        size_t evictedRecords() const {
+            return m_evicted.load(std::memory_order_relaxed);
+        }
+
     private:
         class IssueRecord {
         public:
             IssueRecord();
             void reset();
 
-            std::time_t m_lastOccurance;
-            std::time_t m_lastReport;
-            std::string m_lastOccuranceFormatted;
+            system_clock::time_point m_lastOccurance;
+            system_clock::time_point m_lastReport;
+            int64_t m_allowedAt;		/**< \brief theoretical arrival time of the next issue for the token bucket mode */
+            std::unique_ptr<ers::Issue> m_suppressedIssue;	/**< \brief copy of the first suppressed issue, used for reporting at eviction */
             int m_initialCounter;
             int m_threshold;
             int m_suppressedCounter;
         };
 
+        /** Part of the table of issue records, which is protected by its own mutex.
+          * The records are kept in an open addressing hash table with linear probing,
+          * which is indexed by the hash of the issue call site.
+          */
+        struct Shard {
+            struct Slot {
+                uint64_t m_key = 0;	/**< \brief hash of the call site, 0 for an empty slot */
+                IssueRecord m_record;
+            };
+
+            Shard();
+
+            std::mutex m_mutex;
+            std::vector<Slot> m_slots;
+            size_t m_size;
+        };
+
+        static const int ShardBits = 4;
+        static const size_t ShardsNumber = 1 << ShardBits;
+
     private:
         void throttle(IssueRecord &record, const ers::Issue &issue);
 
+        void limitRate(IssueRecord &record, const ers::Issue &issue);
+
+        bool acquireGlobal(int64_t now);
+
         void reportSuppression(IssueRecord &record, const ers::Issue &issue);
 
-        typedef std::map<std::string, IssueRecord> IssueMap;
-        IssueMap m_issueMap;
+        IssueRecord& findRecord(Shard &shard, uint64_t key, const system_clock::time_point &now);
+
+        void grow(Shard &shard);
+
+        void expire(Shard &shard, const system_clock::time_point &now);
+
+        void evictOldest(Shard &shard);
+
+        void evict(Shard &shard, size_t index);
+
+        Shard m_shards[ShardsNumber];
 
         int m_initialThreshold;
-        int m_timeLimit;
-        std::mutex m_mutex;
+        std::chrono::seconds m_timeLimit;
+        bool m_tokenBucket;			/**< \brief the rate of issues is limited by token buckets */
+        int64_t m_interval;			/**< \brief nanoseconds per issue of the same type */
+        int64_t m_tolerance;			/**< \brief burst of the issues of the same type in nanoseconds */
+        int64_t m_globalInterval;		/**< \brief nanoseconds per issue, 0 if there is no global limit */
+        int64_t m_globalTolerance;
+        std::atomic<int64_t> m_globalAllowedAt;
+        size_t m_shardCapacity;			/**< \brief maximum number of records in a shard */
+        std::chrono::seconds m_idleTimeout;
+        std::atomic<size_t> m_expired;		/**< \brief number of records discarded because they were idle */
+        std::atomic<size_t> m_evicted;		/**< \brief number of records discarded because the table was full */
+        std::atomic<system_clock::time_point> m_lastExpiration;	/**< \brief last time when idle records were discarded */
     };
 }
 
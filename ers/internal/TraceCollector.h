@@ -0,0 +1,175 @@
+/*
+ *  TraceCollector.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file TraceCollector.h This file defines the per-thread buffers of the ERS_TRACE records and
+  * the collector which converts them to issues.
+  * \brief ers header file
+  */
+
+#ifndef ERS_TRACE_COLLECTOR_H
+#define ERS_TRACE_COLLECTOR_H
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ers/Trace.h>
+
+namespace ers
+{
+    template <class > class SingletonCreator;
+
+    /** This class implements a buffer which keeps the trace records produced by a single thread until
+      * they are processed by the collector thread. The buffer is a single producer single consumer ring.
+      * Every record starts at an 8 bytes aligned offset with a header which contains the identifier of the
+      * statement, the size of the arguments and the time, and is followed by the arguments.
+      * Records never wrap around the end of the buffer, a record with zero identifier tells the reader
+      * to continue from the beginning of the buffer.
+      */
+    class TraceBuffer
+    {
+      public:
+	struct Header
+	{
+	    uint32_t	id;
+	    uint32_t	size;		/**< \brief size of the arguments */
+	    int64_t	time;		/**< \brief nanoseconds since the epoch */
+	};
+
+	static uint64_t record_size( size_t arguments_size )
+	{ return ( sizeof( Header ) + arguments_size + 7 ) & ~uint64_t( 7 ); }
+
+	explicit TraceBuffer( size_t capacity );
+
+	/** \return buffer of the current thread */
+	static TraceBuffer & instance()
+	{
+	    thread_local Owner owner;
+	    return *owner.buffer;
+	}
+
+	/** \return pointer to the space for a record of the given size or 0 if the buffer is full */
+	char * reserve( uint64_t size )
+	{
+	    uint64_t head = m_head.load( std::memory_order_relaxed );
+	    uint64_t position = head % m_capacity;
+	    uint64_t contiguous = m_capacity - position;
+	    uint64_t needed = size <= contiguous ? size : size + contiguous;
+	    if ( m_capacity - ( head - m_tail.load( std::memory_order_acquire ) ) < needed )
+	    {
+		m_dropped.fetch_add( 1, std::memory_order_relaxed );
+		return 0;
+	    }
+	    if ( size > contiguous )
+	    {
+		uint32_t wrap = 0;
+		memcpy( m_data.get() + position, &wrap, sizeof( wrap ) );
+		m_head.store( head + contiguous, std::memory_order_release );
+		position = 0;
+	    }
+	    return m_data.get() + position;
+	}
+
+	/** makes the record of the given size, which has been written to the reserved space, visible to the reader */
+	void commit( uint64_t size )
+	{ m_head.store( m_head.load( std::memory_order_relaxed ) + size, std::memory_order_release ); }
+
+	pid_t thread_id() const
+	{ return m_thread_id; }
+
+      private:
+	friend class TraceCollector;
+
+	/** Marks the buffer of a thread as closed when the thread exits, the buffer
+	  * is deleted by the collector after the remaining records are processed. */
+	struct Owner
+	{
+	    Owner() : buffer( create() ) { ; }
+	    ~Owner() { buffer->m_closed.store( true, std::memory_order_release ); }
+	    TraceBuffer * const buffer;
+	};
+
+	static TraceBuffer * create();
+
+	const uint64_t			m_capacity;
+	std::unique_ptr<char[]>		m_data;
+	std::atomic<uint64_t>		m_head;
+	std::atomic<uint64_t>		m_tail;
+	std::atomic<uint64_t>		m_dropped;	/**< \brief number of records lost because the buffer was full */
+	std::atomic<bool>		m_closed;	/**< \brief the owning thread has exited */
+	const pid_t			m_thread_id;
+    };
+
+    /** This class registers ERS_TRACE statements and runs a thread which periodically converts
+      * the records from the trace buffers of all threads to ers::Message issues and sends them to
+      * the ERS debug stream. The trace records are also processed when the ERS streams are flushed,
+      * e.g. when the application exits or crashes. The records are always processed by the collector
+      * thread, since at exit the thread local objects used by the streams in the main thread are destroyed.
+      */
+    class TraceCollector
+    {
+	template <class> friend class SingletonCreator;
+
+      public:
+	static TraceCollector & instance();				/**< \brief method to access singleton */
+
+	/** registers the statement described by the given site and the types of its arguments
+	  * \return identifier of the statement
+	  */
+	uint32_t register_site( TraceSite & site, const char * format, std::initializer_list<uint8_t> types );
+
+	/** waits for the records which are currently in the trace buffers to be processed,
+	  * does nothing if ERS_TRACE has never been used */
+	static void flush();
+
+      private:
+	friend class TraceBuffer;
+
+	struct Site
+	{
+	    const TraceSite *		site;
+	    const char *		format;
+	    std::vector<uint8_t>	types;
+	    std::vector<std::string>	qualifiers;
+	};
+
+	TraceCollector();
+
+	void add_buffer( TraceBuffer * buffer );
+
+	void process();
+
+	void process( TraceBuffer & buffer );
+
+	void run();
+
+	static std::atomic<TraceCollector *>	s_instance;
+
+	std::mutex					m_mutex;		/**< \brief protects the sites, the buffers and the counters */
+	std::condition_variable				m_condition;
+	std::deque<Site>				m_sites;
+	std::vector<std::unique_ptr<TraceBuffer>>	m_buffers;
+	uint64_t					m_requested;		/**< \brief number of flush requests */
+	uint64_t					m_processed;		/**< \brief number of flush requests which have been served */
+	std::chrono::milliseconds			m_interval;
+	std::thread::id					m_thread;		/**< \brief the collector thread */
+    };
+}
+
+#endif
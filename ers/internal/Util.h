@@ -15,6 +15,7 @@
 #ifndef ERS_UTIL_H
 #define ERS_UTIL_H
 
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -27,6 +28,12 @@ namespace ers
     int read_from_environment( const char * name, int default_value );
     
     const char * read_from_environment( const char * name, const char * default_value );
+
+    void write_all( int fd, const char * data, size_t size );
+
+    size_t parse_size( const std::string & text );
+
+    std::chrono::seconds parse_duration( const std::string & text );
 }
 
 #endif
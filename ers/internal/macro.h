@@ -13,6 +13,12 @@
 
 ERS_DECLARE_ISSUE( ers, InternalMessage, ERS_EMPTY, ERS_EMPTY )
 
+/** The internal messages are printed with zero verbosity, which shows no stack frames, so their
+  * context never captures the stack and does not use the ers::Configuration singleton. Therefore
+  * these messages can be reported while the singleton is being constructed.
+  */
+#define ERS_INTERNAL_HERE ers::LocalContext( ERS_CALL_SITE, false )
+
 #define ERS_REGISTER_OUTPUT_STREAM( class, name, param ) \
 namespace { \
     struct BOOST_PP_CAT( OutputStreamRegistrator, __LINE__ ) { \
@@ -28,7 +34,7 @@ if ( ers::debug_level() >= level ) \
 { \
     std::ostringstream out; \
     out << message; \
-    ers::InternalMessage info( ERS_HERE, out.str() ); \
+    ers::InternalMessage info( ERS_INTERNAL_HERE, out.str() ); \
     info.set_severity( ers::Severity( ers::Debug, level ) ); \
     ers::StandardStreamOutput::println( std::cout, info, 0 ); \
 } }
@@ -36,7 +42,7 @@ if ( ers::debug_level() >= level ) \
 #define ERS_INTERNAL_INFO( message ) { \
     std::ostringstream out; \
     out << message; \
-    ers::InternalMessage info( ERS_HERE, out.str() ); \
+    ers::InternalMessage info( ERS_INTERNAL_HERE, out.str() ); \
     info.set_severity( ers::Information ); \
     ers::StandardStreamOutput::println( std::cout, info, 0 ); \
 }
@@ -44,7 +50,7 @@ if ( ers::debug_level() >= level ) \
 #define ERS_INTERNAL_WARNING( message ) { \
     std::ostringstream out; \
     out << message; \
-    ers::InternalMessage info( ERS_HERE, out.str() ); \
+    ers::InternalMessage info( ERS_INTERNAL_HERE, out.str() ); \
     info.set_severity( ers::Warning ); \
     ers::StandardStreamOutput::println( std::cerr, info, 0 ); \
 }
@@ -52,7 +58,7 @@ if ( ers::debug_level() >= level ) \
 #define ERS_INTERNAL_ERROR( message ) { \
     std::ostringstream out; \
     out << message; \
-    ers::InternalMessage info( ERS_HERE, out.str() ); \
+    ers::InternalMessage info( ERS_INTERNAL_HERE, out.str() ); \
     info.set_severity( ers::Error ); \
     ers::StandardStreamOutput::println( std::cerr, info, 0 ); \
 }
@@ -60,7 +66,7 @@ if ( ers::debug_level() >= level ) \
 #define ERS_INTERNAL_FATAL( message ) { \
     std::ostringstream out; \
     out << message; \
-    ers::InternalMessage info( ERS_HERE, out.str() ); \
+    ers::InternalMessage info( ERS_INTERNAL_HERE, out.str() ); \
     info.set_severity( ers::Fatal ); \
     ers::StandardStreamOutput::println( std::cerr, info, 0 ); \
     ::exit( 13 ); \
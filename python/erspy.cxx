@@ -148,15 +148,15 @@ namespace
             qualifiers.push_back(PyUnicode_AsUTF8(PyList_GetItem(q, i)));
         }
 
-	std::map<std::string, std::string> parameters;
+	ers::string_map parameters;
 	Py_RH items(PyDict_Items(Py_RH(PyObject_GetAttrString(o, "parameters"))));
         size = PyList_Size( items );
+	parameters.reserve( size );
         for (int i = 0; i < size; ++i ) {
             PyObject * item = PyList_GetItem(items, i);
-            parameters.insert( std::make_pair(
+            parameters.emplace(
         	PyUnicode_AsUTF8(PyTuple_GetItem(item, 0)),
-        	PyUnicode_AsUTF8(PyTuple_GetItem(item, 1))
-        	));
+        	PyUnicode_AsUTF8(PyTuple_GetItem(item, 1)) );
         }
 
 	double t = PyFloat_AsDouble( Py_RH( PyObject_GetAttrString(o, "time")));
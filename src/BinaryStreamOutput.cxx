@@ -0,0 +1,234 @@
+/*
+ *  BinaryStreamOutput.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <string.h>
+
+#include <memory>
+
+#include <ers/BinaryStreamOutput.h>
+#include <ers/IssueFactory.h>
+#include <ers/RemoteContext.h>
+
+const char ers::BinaryStreamOutput::Magic[8] = { 'E', 'R', 'S', 'B', 'I', 'N', '\r', '\n' };
+
+namespace
+{
+    void put_number( std::string & out, uint64_t value )
+    {
+	while ( value >= 0x80 )
+	{
+	    out.push_back( char( value | 0x80 ) );
+	    value >>= 7;
+	}
+	out.push_back( char( value ) );
+    }
+
+    void put_signed( std::string & out, int64_t value )
+    {
+	put_number( out, ( uint64_t( value ) << 1 ) ^ uint64_t( value >> 63 ) );
+    }
+
+    void put_string( std::string & out, const char * value, size_t size )
+    {
+	put_number( out, size );
+	out.append( value, size );
+    }
+
+    void put_string( std::string & out, const std::string & value )
+    {
+	put_string( out, value.data(), value.size() );
+    }
+
+    void put_string( std::string & out, const char * value )
+    {
+	put_string( out, value ? value : "", value ? strlen( value ) : 0 );
+    }
+
+    void put_issue( std::string & out, const ers::Issue & issue )
+    {
+	put_string( out, issue.get_class_name() );
+	out.push_back( char( issue.severity().type ) );
+	put_signed( out, issue.severity().rank );
+	put_signed( out, std::chrono::duration_cast<std::chrono::nanoseconds>(
+					issue.ptime().time_since_epoch() ).count() );
+	put_string( out, issue.message() );
+
+	const ers::Context & context = issue.context();
+	put_string( out, context.package_name() );
+	put_string( out, context.file_name() );
+	put_signed( out, context.line_number() );
+	put_string( out, context.function_name() );
+	put_string( out, context.host_name() );
+	put_signed( out, context.process_id() );
+	put_signed( out, context.thread_id() );
+	put_string( out, context.cwd() );
+	put_signed( out, context.user_id() );
+	put_string( out, context.user_name() );
+	put_string( out, context.application_name() );
+
+	put_number( out, issue.qualifiers().size() );
+	for ( const std::string & q : issue.qualifiers() )
+	    put_string( out, q );
+
+	const ers::string_map & parameters = issue.parameters();
+	put_number( out, parameters.size() );
+	for ( const auto & p : parameters )
+	{
+	    put_string( out, p.first );
+	    put_string( out, p.second );
+	}
+
+	out.push_back( char( issue.cause() != 0 ) );
+	if ( issue.cause() )
+	    put_issue( out, *issue.cause() );
+    }
+
+    /** Reads values from the body of a single record. */
+    struct Reader
+    {
+	const char * data;
+	const char * end;
+
+	uint64_t number()
+	{
+	    uint64_t value = 0;
+	    for ( int shift = 0; shift < 64; shift += 7 )
+	    {
+		if ( data == end )
+		    throw ers::BadBinaryData( ERS_HERE, "record is truncated" );
+		uint8_t byte = *data++;
+		value |= uint64_t( byte & 0x7f ) << shift;
+		if ( !( byte & 0x80 ) )
+		    return value;
+	    }
+	    throw ers::BadBinaryData( ERS_HERE, "integer number is too long" );
+	}
+
+	int64_t signed_number()
+	{
+	    uint64_t value = number();
+	    return int64_t( value >> 1 ) ^ -int64_t( value & 1 );
+	}
+
+	uint8_t byte()
+	{
+	    if ( data == end )
+		throw ers::BadBinaryData( ERS_HERE, "record is truncated" );
+	    return *data++;
+	}
+
+	std::string string()
+	{
+	    uint64_t size = number();
+	    if ( size > uint64_t( end - data ) )
+		throw ers::BadBinaryData( ERS_HERE, "string size exceeds the record size" );
+	    data += size;
+	    return std::string( data - size, size );
+	}
+
+	ers::Issue * issue( int depth )
+	{
+	    if ( depth > 1024 )
+		throw ers::BadBinaryData( ERS_HERE, "chain of causes is too long" );
+
+	    std::string class_name = string();
+	    uint8_t type = byte();
+	    if ( type > ers::Fatal )
+		throw ers::BadBinaryData( ERS_HERE, "unknown severity " + std::to_string( type ) );
+	    ers::Severity severity( ers::severity( type ), signed_number() );
+	    system_clock::time_point time( std::chrono::duration_cast<system_clock::duration>(
+						std::chrono::nanoseconds( signed_number() ) ) );
+	    std::string message = string();
+
+	    std::string package = string();
+	    std::string file = string();
+	    int line = signed_number();
+	    std::string function = string();
+	    std::string host = string();
+	    int pid = signed_number();
+	    int tid = signed_number();
+	    std::string cwd = string();
+	    int uid = signed_number();
+	    std::string user = string();
+	    std::string application = string();
+	    ers::RemoteContext context( package, file, line, function,
+		    ers::RemoteProcessContext( host, pid, tid, cwd, uid, user, application ) );
+
+	    std::vector<std::string> qualifiers( count() );
+	    for ( std::string & q : qualifiers )
+		q = string();
+
+	    ers::string_map parameters;
+	    for ( uint64_t n = count(); n; --n )
+	    {
+		std::string key = string();
+		parameters.emplace_hint( parameters.end(), std::move( key ), string() );
+	    }
+
+	    std::unique_ptr<ers::Issue> cause( byte() ? issue( depth + 1 ) : 0 );
+
+	    return ers::IssueFactory::instance().create( class_name, context, severity, time,
+			message, qualifiers, parameters, cause.release() );
+	}
+
+	/** Reads the number of elements of a sequence, each of them occupies at least one byte */
+	uint64_t count()
+	{
+	    uint64_t n = number();
+	    if ( n > uint64_t( end - data ) )
+		throw ers::BadBinaryData( ERS_HERE, "sequence size exceeds the record size" );
+	    return n;
+	}
+    };
+}
+
+void
+ers::BinaryStreamOutput::encode( std::string & out, const Issue & issue )
+{
+    thread_local std::string body;
+
+    body.clear();
+    body.push_back( char( Version ) );
+    put_issue( body, issue );
+
+    put_number( out, body.size() );
+    out.append( body );
+}
+
+ers::Issue *
+ers::BinaryStreamOutput::decode( const char * & data, const char * end )
+{
+    Reader header{ data, end };
+    uint64_t size;
+    try {
+	size = header.number();
+    }
+    catch ( ers::BadBinaryData & ) {
+	if ( end - data < 10 )
+	    return 0;	// the size itself is incomplete
+	throw;
+    }
+
+    if ( size > uint64_t( end - header.data ) )
+	return 0;
+
+    Reader body{ header.data, header.data + size };
+    uint8_t version = body.byte();
+    if ( version != Version )
+	throw ers::BadBinaryData( ERS_HERE, "unsupported record version " + std::to_string( version ) );
+
+    ers::Issue * issue = body.issue( 0 );
+    if ( body.data != body.end )
+    {
+	delete issue;
+	throw ers::BadBinaryData( ERS_HERE, "record size does not match its content" );
+    }
+
+    data = body.end;
+    return issue;
+}
@@ -0,0 +1,53 @@
+/*
+ *  CallSite.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <string.h>
+
+#include <atomic>
+
+#include <ers/CallSite.h>
+#include <ers/Context.h>
+
+namespace
+{
+    std::atomic<uint32_t>	s_last_id;
+
+    const char * render_position( const char * package_name, const char * file_name,
+				  int line_number, const char * function_name, int verbosity )
+    {
+	return strdup( ers::Context::position(
+		package_name, file_name, line_number, function_name, verbosity ).c_str() );
+    }
+
+    std::string_view short_name( const char * function )
+    {
+	const char * end = strchr( function, '(' );
+	if ( !end )
+	    return function;
+
+	const char * beg = end;
+	while ( beg > function && *(beg-1) != ' ' )
+	    --beg;
+	return std::string_view( beg, end - beg );
+    }
+}
+
+ers::CallSite::CallSite(
+    const char * package_name,
+    const char * file_name,
+    int line_number,
+    const char * function_name )
+  : m_package_name( package_name ),
+    m_file_name( file_name ),
+    m_line_number( line_number ),
+    m_function_name( function_name ),
+    m_short_function_name( short_name( function_name ) ),
+    m_position{ render_position( package_name, file_name, line_number, function_name, 0 ),
+		render_position( package_name, file_name, line_number, function_name, 1 ) },
+    m_id( s_last_id.fetch_add( 1, std::memory_order_relaxed ) + 1 )
+{ ; }
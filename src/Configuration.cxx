@@ -6,14 +6,83 @@
  *  Copyright 2005 CERN. All rights reserved.
  *
  */
+#include <ctype.h>
 #include <cstdio>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <string_view>
 
 #include <ers/Configuration.h>
 #include <ers/ers.h>
+#include <ers/internal/macro.h>
 #include <ers/internal/SingletonCreator.h>
 #include <ers/internal/Util.h>
 
+/** The stack policy is kept in static variables, which are available before the
+  * singleton is constructed, since ERS_HERE is used while it is being constructed.
+  */
+std::atomic<bool> ers::Configuration::s_stack_configured( false );
+std::atomic<int> ers::Configuration::s_stack_severity( ers::Fatal + 1 );
+std::atomic<bool> ers::Configuration::s_stack_on_demand( true );
+std::atomic<unsigned int> ers::Configuration::s_stack_sampling( 0 );
+std::atomic<uint32_t> ers::Configuration::s_debug_epoch( 1 );
+
+/** Immutable table of the debug levels of packages and issue classes. The tables are never deleted,
+  * since they are read without locking, a new table is created each time the levels are given by
+  * a string. The default level is kept outside of the table, so changing it allocates nothing.
+  */
+struct ers::Configuration::DebugLevels
+{
+    typedef std::map<std::string, int, std::less<>> Levels;
+
+    /** \return level of the given issue class or package or the default level if neither is in the table */
+    int find( const char * package_name, const char * issue_class, int default_level ) const
+    {
+	if ( !classes.empty() && issue_class )
+	{
+	    Levels::const_iterator it = classes.find( std::string_view( issue_class ) );
+	    if ( it != classes.end() )
+		return it->second;
+	}
+
+	if ( !packages.empty() && package_name )
+	{
+	    std::string_view name( package_name );
+	    while ( true )
+	    {
+		Levels::const_iterator it = packages.find( name );
+		if ( it != packages.end() )
+		    return it->second;
+
+		std::string_view::size_type dot = name.rfind( '.' );
+		if ( dot == std::string_view::npos )
+		    break;
+		name = name.substr( 0, dot );
+	    }
+	}
+	return default_level;
+    }
+
+    Levels	packages;
+    Levels	classes;
+};
+
+namespace
+{
+    std::mutex s_debug_mutex;
+
+    bool parse_level( const std::string & text, int & level )
+    {
+	char c;
+	if ( sscanf( text.c_str(), " %d %c", &level, &c ) == 1 )
+	    return true;
+
+	ERS_INTERNAL_ERROR( "Wrong value \"" << text << "\" is given for the debug level" )
+	return false;
+    }
+}
+
 /** This method returns the singleton instance. 
   * It should be used for every operation on the factory. 
   * \return a reference to the singleton instance 
@@ -33,21 +102,197 @@ ers::Configuration::instance()
   */
 ers::Configuration::Configuration()
   : m_debug_level( 0 ),
+    m_debug_levels( 0 ),
     m_verbosity_level( 0 )
 {
-    m_debug_level = read_from_environment( "TDAQ_ERS_DEBUG_LEVEL", m_debug_level );
+    debug_level( read_from_environment( "TDAQ_ERS_DEBUG_LEVEL", "0" ) );
     m_verbosity_level = read_from_environment( "TDAQ_ERS_VERBOSITY_LEVEL", m_verbosity_level );
+    stack_policy( read_from_environment( "TDAQ_ERS_STACK", "demand" ) );
+}
+
+int
+ers::Configuration::debug_level( const char * package_name, const char * issue_class ) const
+{
+    const DebugLevels * levels = m_debug_levels.load( std::memory_order_acquire );
+    int default_level = m_debug_level.load( std::memory_order_relaxed );
+    return levels ? levels->find( package_name, issue_class, default_level ) : default_level;
+}
+
+void
+ers::Configuration::debug_level( int debug_level )
+{
+    std::scoped_lock lock( s_debug_mutex );
+    set_debug_levels( debug_level, m_debug_levels.load( std::memory_order_relaxed ) );
+}
+
+void
+ers::Configuration::debug_level( const std::string & text )
+{
+    std::scoped_lock lock( s_debug_mutex );
+    int default_level = m_debug_level.load( std::memory_order_relaxed );
+    DebugLevels * levels = new DebugLevels;
+
+    std::vector<std::string> tokens;
+    ers::tokenize( text, ",", tokens );
+    for ( size_t i = 0; i < tokens.size(); ++i )
+    {
+	const std::string & token = tokens[i];
+	std::string::size_type eq = token.find( '=' );
+	int level;
+	if ( eq == std::string::npos )
+	{
+	    if ( parse_level( token, level ) )
+		default_level = level;
+	}
+	else if ( eq == 0 )
+	{
+	    ERS_INTERNAL_ERROR( "Package or issue name is missing in the \"" << token << "\" debug level" )
+	}
+	else if ( parse_level( token.substr( eq + 1 ), level ) )
+	{
+	    std::string name( token, 0, eq );
+	    ( name.find( "::" ) == std::string::npos ? levels->packages : levels->classes )[name] = level;
+	}
+    }
+
+    if ( levels->packages.empty() && levels->classes.empty() )
+    {
+	delete levels;
+	levels = 0;
+    }
+    set_debug_levels( default_level, levels );
+}
+
+/** Publishes the new debug levels, must be called with the s_debug_mutex locked. The epoch is
+  * changed after the levels, so a statement which sees the new epoch reads the new levels.
+  */
+void
+ers::Configuration::set_debug_levels( int default_level, const DebugLevels * levels )
+{
+    m_debug_level.store( default_level, std::memory_order_relaxed );
+    m_debug_levels.store( levels, std::memory_order_release );
+    s_debug_epoch.fetch_add( 1, std::memory_order_release );
+}
+
+int
+ers::DebugSite::resolve()
+{
+    Configuration & configuration = Configuration::instance();
+    uint64_t epoch = Configuration::s_debug_epoch.load( std::memory_order_acquire );
+    int level = configuration.debug_level( m_package_name, m_issue_class );
+    m_cached.store( ( epoch << 32 ) | biased( level ), std::memory_order_relaxed );
+    return level;
 }
 
 void 
 ers::Configuration::verbosity_level( int verbosity_level )
 {
     m_verbosity_level = verbosity_level;
+    // standard streams print stack frames for the verbosity level higher than 3
+    StreamManager::instance().update_enabled();
+}
+
+void 
+ers::Configuration::stack_policy( const std::string & policy )
+{
+    int severity = ers::Fatal + 1;
+    bool on_demand = false;
+    unsigned int sampling = 0;
+
+    std::vector<std::string> tokens;
+    ers::tokenize( policy, ",", tokens );
+    for ( size_t i = 0; i < tokens.size(); ++i )
+    {
+	const std::string & token = tokens[i];
+	unsigned int n = 0;
+	if ( token == "all" )
+	{
+	    severity = ers::Debug;
+	}
+	else if ( token == "none" )
+	{
+	    ;
+	}
+	else if ( token == "demand" )
+	{
+	    on_demand = true;
+	}
+	else if ( sscanf( token.c_str(), "sample(1/%u)", &n ) == 1 && n )
+	{
+	    sampling = n;
+	}
+	else if ( token.size() > 1 && token[token.size() - 1] == '+' )
+	{
+	    std::string name( token, 0, token.size() - 1 );
+	    for ( size_t c = 0; c < name.size(); ++c )
+		name[c] = ::toupper( name[c] );
+
+	    short ss = ers::Debug;
+	    for( ; ss <= ers::Fatal && name != ers::to_string( (ers::severity)ss ); ++ss )
+		;
+
+	    if ( ss <= ers::Fatal )
+		severity = std::min<int>( severity, ss );
+	    else
+		ERS_INTERNAL_ERROR( "Unknown severity \"" << token << "\" is used in the stack policy" )
+	}
+	else
+	{
+	    ERS_INTERNAL_ERROR( "Unknown token \"" << token << "\" is used in the stack policy" )
+	}
+    }
+
+    m_stack_policy = policy;
+    s_stack_severity = severity;
+    s_stack_on_demand = on_demand;
+    s_stack_sampling = sampling;
+}
+
+/** Decides if the stack frames have to be captured for a new issue. This function is
+  * called for every issue, so it must be cheap for the issues which will have no stack.
+  * \param severity expected severity of the issue
+  */
+bool 
+ers::Configuration::stack_wanted( ers::severity severity )
+{
+    // The flag is set before the singleton is created, so the issues reported
+    // by its constructor use the default policy
+    if ( !s_stack_configured.load( std::memory_order_relaxed ) && !s_stack_configured.exchange( true ) )
+	instance();
+
+    if ( severity >= s_stack_severity.load( std::memory_order_relaxed ) )
+	return true;
+
+    if ( s_stack_on_demand.load( std::memory_order_relaxed )
+	&& StreamManager::is_stack_needed( severity ) )
+	return true;
+
+    unsigned int sampling = s_stack_sampling.load( std::memory_order_relaxed );
+    if ( sampling )
+    {
+	static thread_local unsigned int counter;
+	if ( ++counter >= sampling )
+	{
+	    counter = 0;
+	    return true;
+	}
+    }
+    return false;
 }
 
 std::ostream & 
 ers::operator<<( std::ostream & out, const ers::Configuration & conf )
 {
-    out << "debug level = " << conf.m_debug_level << " verbosity level = " << conf.m_verbosity_level;
+    out << "debug level = " << conf.debug_level();
+    const ers::Configuration::DebugLevels * levels = conf.m_debug_levels.load( std::memory_order_acquire );
+    if ( levels )
+    {
+	for ( const auto & l : levels->packages )
+	    out << "," << l.first << "=" << l.second;
+	for ( const auto & l : levels->classes )
+	    out << "," << l.first << "=" << l.second;
+    }
+    out << " verbosity level = " << conf.m_verbosity_level
+	<< " stack policy = " << conf.m_stack_policy;
     return out;
 }
@@ -12,8 +12,14 @@
 #include <pwd.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <sstream>
+#include <unordered_map>
 
 #ifndef __rtems__
 #include <execinfo.h>
@@ -23,6 +29,7 @@ char** backtrace_symbols (void ** , int size) {
 }
 #endif
 
+#include <ers/CallSite.h>
 #include <ers/Context.h>
 #include <ers/Configuration.h>
 
@@ -53,6 +60,152 @@ namespace
 	return std::string( mangled );
     }
 
+    std::atomic<bool> s_crashing( false );
+
+    /** Process-wide cache of the demangled symbols for the stack frame addresses. The cache keeps
+      * at most MaxSize symbols, when it is full the symbol which has not been used for the longest
+      * time is removed, as approximated by the second chance algorithm. The symbols are reference
+      * counted and every thread holds the ones returned by its last lookup, so the views to them
+      * remain valid until the next lookup in the same thread even if they are removed from the cache.
+      * After a crash the cache is not used at all, since the crash may have happened in the same
+      * thread while the cache was locked.
+      */
+    class SymbolCache
+    {
+      public:
+	static SymbolCache & instance()
+	{
+	    static SymbolCache * cache = new SymbolCache();
+	    return *cache;
+	}
+
+	void lookup( void * const * frames, int size, std::vector<std::string_view> & symbols );
+
+      private:
+	typedef std::shared_ptr<const std::string> Symbol;
+
+	struct Entry
+	{
+	    explicit Entry( const Symbol & s )
+	      : symbol( s ),
+		used( false )
+	    { ; }
+
+	    Symbol			symbol;
+	    mutable std::atomic<bool>	used;	/**< \brief set by the lookups, cleared by the eviction */
+	};
+
+	void evict( );
+
+	static const size_t MaxSize = 16384;
+
+	std::shared_mutex				m_mutex;
+	std::unordered_map<void *, Entry>		m_symbols;
+	std::deque<void *>				m_order;	/**< \brief addresses in the order of the eviction checks */
+    };
+
+    /** Must be called with the unique lock held. Removes the first address in the order of insertion,
+      * which has not been used since it has been checked last time, the used ones are checked again later.
+      */
+    void
+    SymbolCache::evict( )
+    {
+	while ( !m_order.empty() )
+	{
+	    void * address = m_order.front();
+	    m_order.pop_front();
+
+	    auto it = m_symbols.find( address );
+	    if ( it->second.used.exchange( false, std::memory_order_relaxed ) )
+	    {
+		m_order.push_back( address );
+	    }
+	    else
+	    {
+		m_symbols.erase( it );
+		return ;
+	    }
+	}
+    }
+
+    void
+    SymbolCache::lookup( void * const * frames, int size, std::vector<std::string_view> & symbols )
+    {
+	thread_local std::vector<void *> missed;
+	thread_local std::vector<Symbol> pinned;
+
+	bool crashing = s_crashing.load( std::memory_order_relaxed );
+
+	symbols.assign( size, std::string_view() );
+	missed.clear();
+	pinned.clear();
+
+	if ( crashing )
+	{
+	    missed.assign( frames, frames + size );
+	}
+	else
+	{
+	    std::shared_lock lock( m_mutex );
+	    for ( int i = 0; i < size; ++i )
+	    {
+		auto it = m_symbols.find( frames[i] );
+		if ( it != m_symbols.end() )
+		{
+		    it->second.used.store( true, std::memory_order_relaxed );
+		    pinned.push_back( it->second.symbol );
+		    symbols[i] = *pinned.back();
+		}
+		else
+		{
+		    missed.push_back( frames[i] );
+		}
+	    }
+	}
+
+	if ( missed.empty() )
+	    return ;
+
+	char ** names = backtrace_symbols( missed.data(), missed.size() );
+	if ( !names )
+	{
+	    symbols.clear();
+	    return ;
+	}
+
+	std::unique_lock lock( m_mutex, std::defer_lock );
+	if ( !crashing )
+	    lock.lock();
+
+	for ( size_t m = 0, i = 0; m < missed.size(); ++m )
+	{
+	    while ( frames[i] != missed[m] || !symbols[i].empty() )
+		++i;
+
+	    Symbol symbol;
+	    if ( lock.owns_lock() )
+	    {
+		auto it = m_symbols.find( missed[m] );
+		if ( it == m_symbols.end() )
+		{
+		    if ( m_symbols.size() >= MaxSize )
+			evict();
+		    it = m_symbols.try_emplace( missed[m], std::make_shared<const std::string>( demangle( names[m] ) ) ).first;
+		    m_order.push_back( missed[m] );
+		}
+		symbol = it->second.symbol;
+	    }
+	    else
+	    {
+		symbol = std::make_shared<const std::string>( demangle( names[m] ) );
+	    }
+
+	    pinned.push_back( symbol );
+	    symbols[i] = *symbol;
+	}
+	free( names );
+    }
+
     void
     print_function( std::ostream & out, const char * function, int verbosity )
     {
@@ -80,43 +233,94 @@ namespace
     }
 }
 
+void
+ers::Context::set_crashing( )
+{
+    s_crashing.store( true, std::memory_order_relaxed );
+}
+
+bool
+ers::Context::is_crashing( )
+{
+    return s_crashing.load( std::memory_order_relaxed );
+}
+
 std::vector<std::string>
 ers::Context::stack( ) const
 {
-    std::vector<std::string>	stack;
-    stack.reserve( stack_size() );
-    char ** symbols = backtrace_symbols( (void**)stack_symbols(), stack_size() );
-    
-    if (symbols) {
-        for (int i = 1; i < stack_size(); i++) {
-            stack.push_back( demangle(symbols[i]) );
-        }
-        free(symbols);
+    const std::vector<std::string_view> & frames = stack_view();
+    return std::vector<std::string>( frames.begin(), frames.end() );
+}
+
+/** Returns demangled symbols for the stack frames of this context, except the first one.
+  * The symbols are taken from a process-wide cache, so a stack is symbolised only once.
+  */
+const std::vector<std::string_view> &
+ers::Context::stack_view( ) const
+{
+    thread_local std::vector<std::string_view> stack;
+    if ( stack_size() <= 1 )
+    {
+	stack.clear();
+	return stack;
     }
 
+    SymbolCache::instance().lookup( stack_symbols() + 1, stack_size() - 1, stack );
     return stack;
 }
 
 /** Pretty printed code position 
   * format: package_name/file_name:line_number <function_name>
+  * The position of the issues created with the ERS_HERE macro is rendered once per call site.
   * \return reference to string containing format
   */
 std::string
 ers::Context::position( int verbosity ) const
+{
+    const CallSite * site = call_site();
+    if ( site )
+    {
+	return site->position( verbosity );
+    }
+    return position( package_name(), file_name(), line_number(), function_name(), verbosity );
+}
+
+/** Returns the same string as the position function. The position of the issues created with the
+  * ERS_HERE macro is returned without copying, the others are rendered to a thread local buffer.
+  */
+std::string_view
+ers::Context::position_view( int verbosity ) const
+{
+    const CallSite * site = call_site();
+    if ( site )
+    {
+	return site->position( verbosity );
+    }
+
+    thread_local std::string buffer;
+    buffer = position( package_name(), file_name(), line_number(), function_name(), verbosity );
+    return buffer;
+}
+
+std::string
+ers::Context::position(	const char * package_name,
+			const char * file,
+			int line_number,
+			const char * function_name,
+			int verbosity )
 {
     std::ostringstream out;
-    print_function( out, function_name(), verbosity );
+    print_function( out, function_name, verbosity );
     out << " at ";
     
-    const char * file = file_name();
     if (    file[0] == '.'
     	&&  file[1] == '.'
         &&  file[2] == '/' ) // file name starts with "../"
     {
-	out << package_name() << (file + 2);
+	out << package_name << (file + 2);
     } else {
 	out << file;
     }
-    out << ":" << line_number();
+    out << ":" << line_number;
     return out.str();
 }
@@ -18,6 +18,7 @@
 #include <ers/Issue.h>
 #include <ers/ers.h>
 #include <ers/StandardStreamOutput.h>
+#include <ers/StreamManager.h>
 
 
 ERS_DECLARE_ISSUE(	ers, 
@@ -144,7 +145,10 @@ namespace ers
     
     void ErrorHandler::abort( const ers::Issue & issue )
     {
+        Context::set_crashing();
         StandardStreamOutput::println(std::cerr, issue, 13);
+        // deliver issues which may have been buffered by the output streams
+        StreamManager::instance().flush();
         ::abort();
     }
 }
@@ -13,6 +13,7 @@
 #include <sstream>
 #include <algorithm>
 #include <ctime>
+#include <mutex>
 #include <time.h>
 
 #include <ers/Issue.h>
@@ -28,25 +29,28 @@ ERS_DECLARE_ISSUE( ers, StdIssue, ERS_EMPTY, ERS_EMPTY )
 
 namespace
 {
-    int get_default_qualifiers( std::vector<std::string> & qualifiers )
-    {
-    	static const char * environment = ::getenv( "TDAQ_ERS_QUALIFIERS" );
-        if ( environment )
-        {
-	    ers::tokenize( environment, ",", qualifiers );
-        }
-        return 1;
-    }
-    
-    void add_default_qualifiers( Issue & issue )
+    std::mutex s_render_mutex;
+
+    /** The qualifiers given by the TDAQ_ERS_QUALIFIERS environment variable,
+      * which are interned once when the first issue is created. */
+    struct DefaultQualifiers
     {
-    	static std::vector<std::string> qualifiers;
-        static int _unused_ = get_default_qualifiers( qualifiers );
-	for ( std::vector<std::string>::const_iterator it = qualifiers.begin(); it != qualifiers.end(); ++it )
-        {
-	    issue.add_qualifier( *it );
-        }
-    }    
+	DefaultQualifiers()
+	{
+	    const char * environment = ::getenv( "TDAQ_ERS_QUALIFIERS" );
+	    if ( environment )
+	    {
+		ers::tokenize( environment, ",", names );
+	    }
+	    for ( std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it )
+	    {
+		symbols.push_back( ers::QualifierSet::symbol( *it ) );
+	    }
+	}
+
+	std::vector<std::string>		names;
+	std::vector<ers::QualifierSet::Symbol>	symbols;
+    };
 }
 
 Issue::Issue( const Issue & other )
@@ -55,9 +59,12 @@ Issue::Issue( const Issue & other )
     m_context( other.m_context->clone() ),
     m_message( other.m_message ),
     m_qualifiers( other.m_qualifiers ),
+    m_qualifier_set( other.m_qualifier_set ),
     m_severity( other.m_severity ),
     m_time( other.m_time ),
-    m_values( other.m_values )
+    m_values( other.m_values ),
+    m_typed_values( other.m_typed_values ),
+    m_values_rendered( other.m_values_rendered.load( std::memory_order_acquire ) )
 { ; }
 
 
@@ -70,10 +77,12 @@ Issue::Issue(	const Context & context,
   : m_context( context.clone() ),
     m_message( message ),
     m_severity( ers::Error ),
-    m_time( system_clock::now() )
+    m_time( system_clock::now() ),
+    m_typed_values( false ),
+    m_values_rendered( true )
 {
     add_qualifier( m_context->package_name() );
-    add_default_qualifiers( *this );
+    add_default_qualifiers();
 }
 
 /** This constructor takes another exceptions as its cause.
@@ -84,12 +93,14 @@ Issue::Issue(	const Context & context,
                 const std::exception & cause )
   : m_context( context.clone() ),
     m_severity( ers::Error ),
-    m_time( system_clock::now() )
+    m_time( system_clock::now() ),
+    m_typed_values( false ),
+    m_values_rendered( true )
 {
     const Issue * issue = dynamic_cast<const Issue *>( &cause );
     m_cause.reset( issue ? issue->clone() : new StdIssue( ERS_HERE, cause.what() ) );
     add_qualifier( m_context->package_name() );
-    add_default_qualifiers( *this );
+    add_default_qualifiers();
 }
 
 /** This constructor takes another exceptions as its cause.
@@ -103,12 +114,14 @@ Issue::Issue(	const Context & context,
   : m_context( context.clone() ),
     m_message( message ),
     m_severity( ers::Error ),
-    m_time( system_clock::now() )
+    m_time( system_clock::now() ),
+    m_typed_values( false ),
+    m_values_rendered( true )
 {
     const Issue * issue = dynamic_cast<const Issue *>( &cause );
     m_cause.reset( issue ? issue->clone() : new StdIssue( ERS_HERE, cause.what() ) );
     add_qualifier( m_context->package_name() );
-    add_default_qualifiers( *this );
+    add_default_qualifiers();
 }
 
 Issue::Issue(	Severity severity,
@@ -116,31 +129,122 @@ Issue::Issue(	Severity severity,
                 const ers::Context & context,
 		const std::string & message,
 		const std::vector<std::string> & qualifiers,
-		const std::map<std::string, std::string> & parameters,
+		const string_map & parameters,
 		const ers::Issue * cause )
   : m_cause( cause ),
     m_context( context.clone() ),
     m_message( message ),
-    m_qualifiers( qualifiers ),
     m_severity( severity ),
     m_time( time ),
-    m_values( parameters )
-{ ; }
+    m_values( parameters ),
+    m_typed_values( false ),
+    m_values_rendered( true )
+{
+    set_qualifiers( qualifiers );
+}
 
 ers::Issue::~Issue() noexcept
 { ; }
 
+/** Formats the given time using the strftime format and appends the fraction of the second
+  * with the given number of digits to it. The strftime output is cached for the last seconds
+  * seen by the current thread for a few formats, so in most cases only the fraction has to be formatted.
+  */
+std::string
+ers::Issue::format_time( std::time_t t, const std::string & format, bool isUTC,
+			 int width, long long fraction )
+{
+    struct Prefix
+    {
+	std::string	format;
+	bool		isUTC = false;
+	std::time_t	second = 0;
+	bool		valid = false;
+	char		text[128];
+    };
+
+    static const size_t CacheSize = 4;
+    thread_local Prefix cache[CacheSize];
+    thread_local size_t next = 0;
+
+    Prefix * prefix = 0;
+    for ( size_t i = 0; i < CacheSize; ++i )
+    {
+	if ( cache[i].valid && cache[i].isUTC == isUTC && cache[i].format == format )
+	{
+	    prefix = &cache[i];
+	    break;
+	}
+    }
+
+    if ( !prefix )
+    {
+	prefix = &cache[next];
+	next = ( next + 1 ) % CacheSize;
+	prefix->format = format;
+	prefix->isUTC = isUTC;
+	prefix->valid = false;
+    }
+
+    if ( !prefix->valid || prefix->second != t )
+    {
+	std::tm tm;
+	isUTC ? gmtime_r( &t, &tm ) : localtime_r( &t, &tm );
+	prefix->text[0] = 0;
+	std::strftime( prefix->text, sizeof( prefix->text ) - 16, format.c_str(), &tm );
+	prefix->second = t;
+	prefix->valid = true;
+    }
+
+    std::string result( prefix->text );
+    if ( fraction < 0 )
+    {
+	char buff[32];
+	snprintf( buff, sizeof( buff ), ",%0*.0f", width, (double)fraction );
+	return result += buff;
+    }
+
+    char digits[24];
+    char * end = digits + sizeof( digits );
+    char * p = end;
+    do {
+	*--p = '0' + fraction % 10;
+	fraction /= 10;
+    } while ( fraction );
+
+    while ( end - p < width && p > digits + 1 )
+	*--p = '0';
+    *--p = ',';
+
+    return result.append( p, end - p );
+}
+
 std::time_t 
 ers::Issue::time_t() const
 {
     return system_clock::to_time_t(m_time);
 }
 
+/** Converts typed attributes of this issue to strings. This is done only once, when
+  * the parameters() function is called for the first time.
+  */
+void 
+ers::Issue::render_parameters() const
+{
+    std::lock_guard<std::mutex> lock( s_render_mutex );
+    if ( !m_values_rendered.load( std::memory_order_relaxed ) )
+    {
+	render_values();
+	m_values_rendered.store( true, std::memory_order_release );
+    }
+}
+
 void 
 ers::Issue::get_value( const std::string & key, const char * & value ) const
 {
-    string_map::const_iterator it = m_values.find(key);
-    if ( it != m_values.end() )
+    const string_map & values = parameters();
+    string_map::const_iterator it = values.find(key);
+    if ( it != values.end() )
     {
 	value = it->second.c_str();
     }
@@ -153,8 +257,9 @@ ers::Issue::get_value( const std::string & key, const char * & value ) const
 void 
 ers::Issue::get_value( const std::string & key, std::string & value ) const
 {
-    string_map::const_iterator it = m_values.find(key);
-    if ( it != m_values.end() )
+    const string_map & values = parameters();
+    string_map::const_iterator it = values.find(key);
+    if ( it != values.end() )
     {
 	value = it->second;
     }
@@ -170,11 +275,54 @@ ers::Issue::get_value( const std::string & key, std::string & value ) const
 void 
 Issue::add_qualifier( const std::string & qualifier )
 {
-    if ( std::find( m_qualifiers.begin(), m_qualifiers.end(), qualifier ) == m_qualifiers.end() ) {
+    if ( m_qualifier_set.insert( QualifierSet::symbol( qualifier ) ) ) {
         m_qualifiers.push_back( qualifier );
     }
 }
 
+/** Add a new qualifier to the qualifiers list of this issue
+  * \param qualifier the qualifier to add
+  */
+void 
+Issue::add_qualifier( const char * qualifier )
+{
+    if ( m_qualifier_set.insert( QualifierSet::symbol( qualifier ) ) ) {
+        m_qualifiers.emplace_back( qualifier );
+    }
+}
+
+void 
+Issue::add_default_qualifiers()
+{
+    static const DefaultQualifiers * defaults = new DefaultQualifiers;
+    for ( size_t i = 0; i < defaults->symbols.size(); ++i )
+    {
+	if ( m_qualifier_set.insert( defaults->symbols[i] ) ) {
+	    m_qualifiers.push_back( defaults->names[i] );
+	}
+    }
+}
+
+/** Replaces the qualifiers of this issue with the given ones, which are used as they are
+  * since they normally come from an issue which has been received from another process.
+  * The qualifiers are not added to the table of symbols, so the ones which are unknown
+  * to this process make the qualifier set incomplete.
+  */
+void 
+Issue::set_qualifiers( const std::vector<std::string> & qualifiers )
+{
+    m_qualifiers = qualifiers;
+    m_qualifier_set.clear();
+    for ( std::vector<std::string>::const_iterator it = qualifiers.begin(); it != qualifiers.end(); ++it )
+    {
+	QualifierSet::Symbol symbol = QualifierSet::find( *it );
+	if ( symbol != QualifierSet::NoSymbol )
+	    m_qualifier_set.insert( symbol );
+	else
+	    m_qualifier_set.set_incomplete();
+    }
+}
+
 ers::Severity
 Issue::set_severity( ers::Severity severity ) const
 {
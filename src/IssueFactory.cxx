@@ -74,7 +74,7 @@ ers::IssueFactory::create(	const std::string & name,
     ers::Issue * issue = create( name, context );
     issue->m_message = message;
     issue->m_severity = severity;
-    issue->m_qualifiers = qualifiers;
+    issue->set_qualifiers( qualifiers );
     issue->m_values = parameters;
     issue->m_time = time;
     issue->m_cause.reset( cause );
@@ -11,6 +11,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <iterator>
 
 #include <ers/LocalContext.h>
@@ -79,13 +80,50 @@ ers::LocalContext::LocalContext(
     int line_number,
     const char * function_name,
     bool debug)
-  : m_package_name( package_name ),
+  : m_call_site( 0 ),
+    m_package_name( package_name ),
     m_file_name( filename ),
     m_function_name( function_name ),
     m_line_number( line_number ),
     m_thread_id( gettid() ),
-    m_stack_size( debug ? backtrace( m_stack, std::size(m_stack) ) : 0)
-{ ; }
+    m_stack_size( 0 )
+{
+    if ( debug )
+    {
+	void * frames[64];
+	int size = backtrace( frames, std::size(frames) );
+	if ( size > 0 )
+	{
+	    m_stack.reset( new void*[size] );
+	    std::copy( frames, frames + size, m_stack.get() );
+	    m_stack_size = size;
+	}
+    }
+}
+
+ers::LocalContext::LocalContext(
+    const CallSite & site,
+    bool debug)
+  : m_call_site( &site ),
+    m_package_name( site.package_name() ),
+    m_file_name( site.file_name() ),
+    m_function_name( site.function_name() ),
+    m_line_number( site.line_number() ),
+    m_thread_id( gettid() ),
+    m_stack_size( 0 )
+{
+    if ( debug )
+    {
+	void * frames[64];
+	int size = backtrace( frames, std::size(frames) );
+	if ( size > 0 )
+	{
+	    m_stack.reset( new void*[size] );
+	    std::copy( frames, frames + size, m_stack.get() );
+	    m_stack_size = size;
+	}
+    }
+}
 
 const char *
 ers::LocalContext::application_name() const
@@ -30,8 +30,29 @@ ers::OutputStream::chained( OutputStream * stream )
     m_chained.reset( stream );
 }
 
+void
+ers::OutputStream::flush( )
+{
+    if ( m_chained.get() )
+    {
+    	m_chained->flush();
+    }
+}
+
 bool
 ers::OutputStream::isNull() const
 {
     return false;
 }
+
+bool
+ers::OutputStream::isPassThrough() const
+{
+    return false;
+}
+
+bool
+ers::OutputStream::needsStack() const
+{
+    return true;
+}
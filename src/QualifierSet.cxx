@@ -0,0 +1,104 @@
+/*
+ *  QualifierSet.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <string.h>
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <ers/internal/QualifierSet.h>
+
+namespace
+{
+    /** Process wide table of the qualifier symbols. The table is never destroyed,
+      * so it can be used by issues which are created at exit. */
+    class SymbolTable
+    {
+      public:
+	static SymbolTable & instance()
+	{
+	    static SymbolTable * table = new SymbolTable;
+	    return *table;
+	}
+
+	ers::QualifierSet::Symbol symbol( const char * qualifier, const char * & interned )
+	{
+	    std::string_view key( qualifier );
+	    {
+		std::shared_lock<std::shared_mutex> lock( m_mutex );
+		Symbols::const_iterator it = m_symbols.find( key );
+		if ( it != m_symbols.end() )
+		{
+		    interned = it->first.data();
+		    return it->second;
+		}
+	    }
+
+	    std::unique_lock<std::shared_mutex> lock( m_mutex );
+	    Symbols::const_iterator it = m_symbols.find( key );
+	    if ( it == m_symbols.end() )
+	    {
+		m_names.emplace_back( qualifier );
+		it = m_symbols.emplace( m_names.back(), m_names.size() - 1 ).first;
+	    }
+	    interned = it->first.data();
+	    return it->second;
+	}
+
+	ers::QualifierSet::Symbol find( std::string_view qualifier )
+	{
+	    std::shared_lock<std::shared_mutex> lock( m_mutex );
+	    Symbols::const_iterator it = m_symbols.find( qualifier );
+	    if ( it == m_symbols.end() )
+		return ers::QualifierSet::NoSymbol;
+	    return it->second;
+	}
+
+      private:
+	typedef std::unordered_map<std::string_view, ers::QualifierSet::Symbol> Symbols;
+
+	std::shared_mutex	m_mutex;
+	std::deque<std::string>	m_names;	/**< \brief the strings referenced by the keys of m_symbols */
+	Symbols			m_symbols;
+    };
+}
+
+/** Most of the qualifiers are added from the same few strings, e.g. the package names of the
+  * local contexts, so every thread remembers the recently used addresses and checks that the
+  * string at the address has not been changed before skipping the lookup in the shared table.
+  */
+ers::QualifierSet::Symbol
+ers::QualifierSet::symbol( const char * qualifier )
+{
+    struct Entry
+    {
+	const char *	address = 0;
+	const char *	interned = 0;
+	Symbol		symbol = 0;
+    };
+
+    static const size_t CacheSize = 8;
+    thread_local Entry cache[CacheSize];
+
+    Entry & entry = cache[( reinterpret_cast<uintptr_t>( qualifier ) >> 3 ) % CacheSize];
+    if ( entry.address == qualifier && !strcmp( qualifier, entry.interned ) )
+	return entry.symbol;
+
+    entry.symbol = SymbolTable::instance().symbol( qualifier, entry.interned );
+    entry.address = qualifier;
+    return entry.symbol;
+}
+
+ers::QualifierSet::Symbol
+ers::QualifierSet::find( const std::string & qualifier )
+{
+    return SymbolTable::instance().find( qualifier );
+}
@@ -78,7 +78,7 @@ ers::StandardStreamOutput::print( std::ostream & out, const Issue & issue, int v
 
     if ( verbosity > -1 )
     {
-	out << "[" << issue.context().position( verbosity ) << "] ";
+	out << "[" << issue.context().position_view( verbosity ) << "] ";
     }
 
     out << issue.message();
@@ -113,7 +113,7 @@ ers::StandardStreamOutput::print( std::ostream & out, const Issue & issue, int v
 	std::ios_base::fmtflags flags( out.flags() );
 
 	out << std::left;
-        std::vector<std::string> stack = issue.context().stack();
+        const std::vector<std::string_view> & stack = issue.context().stack_view();
         out << FIELD_SEPARATOR << "stack trace of the crashing thread:";
 	for( size_t i = 0; i < stack.size(); i++ )
 	{
@@ -9,6 +9,7 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 #include <iostream>
 
 #include <ers/Issue.h>
@@ -24,6 +25,7 @@
 #include <ers/internal/PluginManager.h>
 #include <ers/internal/NullStream.h>
 #include <ers/internal/SingletonCreator.h>
+#include <ers/internal/TraceCollector.h>
 
 ERS_DECLARE_ISSUE(      ers,
                         BadConfiguration,
@@ -58,6 +60,12 @@ namespace
 	return env ? env : DefaultOutputStreams[severity];
     }
     
+    void
+    flush_at_exit( )
+    {
+	ers::StreamManager::instance().flush();
+    }
+    
     void
     parse_stream_definition(	const std::string & text,
 				std::vector<std::string> & result )
@@ -109,6 +117,10 @@ namespace ers
               m_in_progress( false )
           { ; }
         
+          // It is not known yet if the real streams will print stack frames
+          bool needsStack() const override
+          { return true; }
+
           void write( const Issue & issue ) 
           {
 	    ers::severity s = issue.severity();
@@ -130,6 +142,7 @@ namespace ers
 	    if ( m_manager.m_out_streams[s].get() == this ) {
 		m_manager.m_out_streams[s] =
 		    std::shared_ptr<OutputStream>( m_manager.setup_stream( s ) );
+		m_manager.update_enabled( s );
 	    }
 	    m_manager.report_issue( s, issue );
             m_in_progress = false;
@@ -143,6 +156,12 @@ namespace ers
     
 }
 
+/** Streams are set up lazily, so all severities are considered enabled until
+  * the corresponding stream is created.
+  */
+std::atomic<bool> ers::StreamManager::s_enabled[ers::Fatal + 1] = { true, true, true, true, true, true };
+std::atomic<bool> ers::StreamManager::s_stack_needed[ers::Fatal + 1] = { true, true, true, true, true, true };
+
 /** This method returns the singleton instance. 
   * It should be used for every operation on the factory. 
   * \return a reference to the singleton instance 
@@ -167,12 +186,32 @@ ers::StreamManager::StreamManager()
        m_init_streams[ss] = std::make_shared<StreamInitializer>( *this );
        m_out_streams[ss] = m_init_streams[ss];
     }
+    
+    // The singleton is never destroyed, so make sure that
+    // the buffered issues are delivered when the process exits
+    ::atexit( flush_at_exit );
 }
 
 /** Destructor - basic cleanup
   */
 ers::StreamManager::~StreamManager()
-{ ; }
+{
+    flush();
+}
+
+/** Delivers all the issues that may have been buffered by the output streams.
+  */
+void
+ers::StreamManager::flush()
+{
+    TraceCollector::flush();
+
+    for( short ss = ers::Debug; ss <= ers::Fatal; ++ss )
+    {	
+	std::shared_ptr<OutputStream> stream = m_out_streams[ss];
+        stream->flush();
+    }
+}
 
 void
 ers::StreamManager::add_output_stream( ers::severity severity, ers::OutputStream * new_stream )
@@ -191,8 +230,51 @@ ers::StreamManager::add_output_stream( ers::severity severity, ers::OutputStream
     {
         m_out_streams[severity] = std::shared_ptr<OutputStream>( new_stream );
     }
+    update_enabled( severity );
 }	
 
+/** Checks if the given stream chain can produce any output.
+  * \return true if the chain consists only of pass-through streams terminated by a null stream
+  */
+bool
+ers::StreamManager::is_null( const OutputStream * stream )
+{
+    while ( stream && stream->isPassThrough() )
+    {
+    	stream = stream->m_chained.get();
+    }
+    return ( !stream || stream->isNull() );
+}
+
+/** Checks if any stream of the given chain may print stack frames of the issues.
+  */
+bool
+ers::StreamManager::needs_stack( const OutputStream * stream )
+{
+    for ( ; stream; stream = stream->m_chained.get() )
+    {
+    	if ( stream->needsStack() )
+            return true;
+    }
+    return false;
+}
+
+void
+ers::StreamManager::update_enabled( ers::severity severity )
+{
+    s_enabled[severity].store( !is_null( m_out_streams[severity].get() ), std::memory_order_relaxed );
+    s_stack_needed[severity].store( needs_stack( m_out_streams[severity].get() ), std::memory_order_relaxed );
+}
+
+void
+ers::StreamManager::update_enabled( )
+{
+    for( short ss = ers::Debug; ss <= ers::Fatal; ++ss )
+    {	
+	update_enabled( (ers::severity)ss );
+    }
+}
+
 void
 ers::StreamManager::add_receiver( const std::string & stream,
 				  const std::string & filter,
@@ -325,7 +407,7 @@ ers::StreamManager::error( const Issue & issue )
 void
 ers::StreamManager::debug( const Issue & issue, int level )
 {
-    if ( Configuration::instance().debug_level() >= level )
+    if ( Configuration::instance().debug_level( issue.context().package_name(), issue.get_class_name() ) >= level )
     {
 	ers::severity old_severity = issue.set_severity( ers::Severity( ers::Debug, level ) );
 	m_out_streams[ers::Debug]->write( issue );
@@ -0,0 +1,485 @@
+/*
+ *  Trace.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include <ers/IssueFactory.h>
+#include <ers/RemoteContext.h>
+#include <ers/ers.h>
+#include <ers/internal/SingletonCreator.h>
+#include <ers/internal/TraceCollector.h>
+#include <ers/internal/Util.h>
+
+std::atomic<ers::TraceCollector *> ers::TraceCollector::s_instance;
+
+namespace
+{
+    const size_t DefaultBufferSize = 1024*1024;
+    const int DefaultInterval = 100;
+
+    // Crash and exit handlers give up waiting for the collector thread after this time
+    const std::chrono::milliseconds FlushTimeout( 500 );
+
+    /** Reads arguments of a single trace record. */
+    struct ArgumentReader
+    {
+	const char * data;
+	const char * end;
+
+	template <class T>
+	bool get( T & value )
+	{
+	    if ( size_t( end - data ) < sizeof( T ) )
+		return false;
+	    memcpy( &value, data, sizeof( T ) );
+	    data += sizeof( T );
+	    return true;
+	}
+
+	bool get( std::string & value )
+	{
+	    uint32_t size;
+	    if ( !get( size ) || size_t( end - data ) < size )
+		return false;
+	    value.assign( data, size );
+	    data += size;
+	    return true;
+	}
+    };
+
+    template <class T>
+    void append_formatted( std::string & out, const std::string & spec, T value )
+    {
+	char buffer[256];
+	int n = snprintf( buffer, sizeof( buffer ), spec.c_str(), value );
+	if ( n < 0 )
+	    return ;
+	if ( size_t( n ) < sizeof( buffer ) )
+	{
+	    out.append( buffer, n );
+	    return ;
+	}
+	std::unique_ptr<char[]> big( new char[n + 1] );
+	snprintf( big.get(), n + 1, spec.c_str(), value );
+	out.append( big.get(), n );
+    }
+
+    /** Reads the next argument as an integer, which is used for the '*' width or precision. */
+    bool next_integer( ArgumentReader & in, const std::vector<uint8_t> & types, size_t & index, long long & value )
+    {
+	if ( index >= types.size() )
+	    return false;
+
+	switch ( types[index++] )
+	{
+	    case ers::TraceArgument::Signed:
+	    case ers::TraceArgument::Unsigned:
+	    case ers::TraceArgument::Pointer:
+	    {
+		int64_t v;
+		if ( !in.get( v ) ) return false;
+		value = v;
+		return true;
+	    }
+	    case ers::TraceArgument::Double:
+	    {
+		double v;
+		if ( !in.get( v ) ) return false;
+		value = v;
+		return true;
+	    }
+	    default:
+	    {
+		std::string v;
+		if ( !in.get( v ) ) return false;
+		value = atoll( v.c_str() );
+		return true;
+	    }
+	}
+    }
+
+    /** Formats the message of a trace record using the printf like format of its statement.
+      * The conversions are adapted to the types of the stored arguments, so a mismatch between
+      * the format and the arguments can not cause undefined behavior.
+      */
+    std::string format_message( const char * format, const std::vector<uint8_t> & types,
+				const char * data, const char * end )
+    {
+	static const char * const Flags = "-+ #0'";
+	static const char * const Lengths = "hlLqjzt";
+	static const char * const Integers = "diouxXc";
+	static const char * const Floats = "eEfFgGaA";
+
+	ArgumentReader in{ data, end };
+	size_t index = 0;
+	std::string out;
+	out.reserve( 128 );
+
+	for ( const char * p = format; *p; )
+	{
+	    const char * percent = strchr( p, '%' );
+	    if ( !percent )
+	    {
+		out.append( p );
+		break;
+	    }
+	    out.append( p, percent - p );
+
+	    p = percent + 1;
+	    if ( *p == '%' )
+	    {
+		out.push_back( '%' );
+		++p;
+		continue;
+	    }
+
+	    std::string spec( "%" );
+	    while ( *p && strchr( Flags, *p ) )
+		spec.push_back( *p++ );
+
+	    for ( int part = 0; part < 2; ++part )
+	    {
+		if ( part == 1 )
+		{
+		    if ( *p != '.' )
+			break;
+		    spec.push_back( *p++ );
+		}
+		if ( *p == '*' )
+		{
+		    long long value = 0;
+		    next_integer( in, types, index, value );
+		    spec += std::to_string( value );
+		    ++p;
+		}
+		while ( isdigit( *p ) )
+		    spec.push_back( *p++ );
+	    }
+
+	    while ( *p && strchr( Lengths, *p ) )
+		++p;
+
+	    char conversion = *p;
+	    if ( !conversion )
+	    {
+		out.append( percent );
+		break;
+	    }
+	    ++p;
+
+	    if ( conversion == 'n' )
+		continue;
+
+	    if ( index >= types.size() )
+	    {
+		out.append( percent, p - percent );
+		continue;
+	    }
+
+	    bool integer = strchr( Integers, conversion );
+	    bool floating = strchr( Floats, conversion );
+	    switch ( types[index++] )
+	    {
+		case ers::TraceArgument::Signed:
+		{
+		    int64_t v = 0;
+		    in.get( v );
+		    if ( floating )
+			append_formatted( out, spec + conversion, double( v ) );
+		    else if ( conversion == 'c' )
+			append_formatted( out, spec + 'c', int( v ) );
+		    else if ( conversion == 'p' )
+			append_formatted( out, spec + 'p', reinterpret_cast<void *>( v ) );
+		    else
+			append_formatted( out, spec + "ll" + ( integer ? conversion : 'd' ), (long long)v );
+		    break;
+		}
+		case ers::TraceArgument::Unsigned:
+		{
+		    uint64_t v = 0;
+		    in.get( v );
+		    if ( floating )
+			append_formatted( out, spec + conversion, double( v ) );
+		    else if ( conversion == 'c' )
+			append_formatted( out, spec + 'c', int( v ) );
+		    else if ( conversion == 'p' )
+			append_formatted( out, spec + 'p', reinterpret_cast<void *>( v ) );
+		    else
+			append_formatted( out, spec + "ll" + ( integer ? conversion : 'u' ), (unsigned long long)v );
+		    break;
+		}
+		case ers::TraceArgument::Double:
+		{
+		    double v = 0;
+		    in.get( v );
+		    if ( integer && conversion != 'c' )
+			append_formatted( out, spec + "ll" + conversion, (long long)v );
+		    else
+			append_formatted( out, spec + ( floating ? conversion : 'g' ), v );
+		    break;
+		}
+		case ers::TraceArgument::Pointer:
+		{
+		    uint64_t v = 0;
+		    in.get( v );
+		    if ( integer && conversion != 'c' )
+			append_formatted( out, spec + "ll" + conversion, (unsigned long long)v );
+		    else
+			append_formatted( out, spec + 'p', reinterpret_cast<void *>( v ) );
+		    break;
+		}
+		default:
+		{
+		    std::string v;
+		    in.get( v );
+		    append_formatted( out, spec + 's', v.c_str() );
+		}
+	    }
+	}
+	return out;
+    }
+}
+
+uint32_t
+ers::trace_register( TraceSite & site, const char * format, std::initializer_list<uint8_t> types )
+{
+    return TraceCollector::instance().register_site( site, format, types );
+}
+
+char *
+ers::trace_reserve( uint32_t id, size_t arguments_size )
+{
+    char * p = TraceBuffer::instance().reserve( TraceBuffer::record_size( arguments_size ) );
+    if ( !p )
+	return 0;
+
+    TraceBuffer::Header header = { id, uint32_t( arguments_size ),
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(
+		    std::chrono::system_clock::now().time_since_epoch() ).count() };
+    memcpy( p, &header, sizeof( header ) );
+    return p + sizeof( header );
+}
+
+void
+ers::trace_commit( size_t arguments_size )
+{
+    TraceBuffer::instance().commit( TraceBuffer::record_size( arguments_size ) );
+}
+
+ers::TraceBuffer::TraceBuffer( size_t capacity )
+  : m_capacity( std::max<size_t>( ( capacity + 7 ) & ~size_t( 7 ), 4096 ) ),
+    m_data( new char[m_capacity] ),
+    m_head( 0 ),
+    m_tail( 0 ),
+    m_dropped( 0 ),
+    m_closed( false ),
+    m_thread_id( gettid() )
+{ ; }
+
+ers::TraceBuffer *
+ers::TraceBuffer::create()
+{
+    static const char * env = ::getenv( "TDAQ_ERS_TRACE_BUFFER_SIZE" );
+    static const size_t size = env ? ers::parse_size( env ) : DefaultBufferSize;
+
+    TraceBuffer * buffer = new TraceBuffer( size );
+    TraceCollector::instance().add_buffer( buffer );
+    return buffer;
+}
+
+ers::TraceCollector &
+ers::TraceCollector::instance()
+{
+    static ers::TraceCollector * instance = ers::SingletonCreator<ers::TraceCollector>::create();
+    return *instance;
+}
+
+ers::TraceCollector::TraceCollector()
+  : m_requested( 0 ),
+    m_processed( 0 ),
+    m_interval( ers::read_from_environment( "TDAQ_ERS_TRACE_INTERVAL", DefaultInterval ) )
+{
+    if ( m_interval.count() <= 0 )
+    {
+	m_interval = std::chrono::milliseconds( DefaultInterval );
+    }
+
+    // the records are flushed by the stream manager at exit, make sure it exists
+    ers::StreamManager::instance();
+
+    // the collector is never destroyed, so its thread can not be joined
+    std::thread thread( &ers::TraceCollector::run, this );
+    m_thread = thread.get_id();
+    thread.detach();
+    s_instance.store( this, std::memory_order_release );
+}
+
+uint32_t
+ers::TraceCollector::register_site( TraceSite & site, const char * format, std::initializer_list<uint8_t> types )
+{
+    // the qualifiers are the same for all the records of the statement, so they are computed only once
+    ers::Message message( ers::LocalContext( site.package, site.file, site.line, site.function ), "" );
+
+    std::unique_lock lock( m_mutex );
+    uint32_t id = site.id.load( std::memory_order_relaxed );
+    if ( !id )
+    {
+	m_sites.push_back( Site{ &site, format, types, message.qualifiers() } );
+	id = m_sites.size();
+	site.id.store( id, std::memory_order_release );
+    }
+    return id;
+}
+
+void
+ers::TraceCollector::add_buffer( TraceBuffer * buffer )
+{
+    std::unique_lock lock( m_mutex );
+    m_buffers.emplace_back( buffer );
+}
+
+void
+ers::TraceCollector::flush()
+{
+    TraceCollector * collector = s_instance.load( std::memory_order_acquire );
+    if ( !collector )
+    {
+	return ;
+    }
+
+    if ( std::this_thread::get_id() == collector->m_thread )
+    {
+	collector->process();
+	return ;
+    }
+
+    std::unique_lock lock( collector->m_mutex );
+    uint64_t request = ++collector->m_requested;
+    collector->m_condition.notify_all();
+    collector->m_condition.wait_for( lock, FlushTimeout,
+	    [collector, request]{ return collector->m_processed >= request; } );
+}
+
+void
+ers::TraceCollector::run()
+{
+    while ( true )
+    {
+	std::unique_lock lock( m_mutex );
+	m_condition.wait_for( lock, m_interval, [this]{ return m_requested != m_processed; } );
+	uint64_t request = m_requested;
+	lock.unlock();
+
+	process();
+
+	lock.lock();
+	m_processed = request;
+	m_condition.notify_all();
+    }
+}
+
+/** Processes the records of all the trace buffers and deletes the buffers of the threads which have exited.
+  * Must be called by the collector thread only.
+  */
+void
+ers::TraceCollector::process()
+{
+    std::vector<TraceBuffer *> buffers;
+    {
+	std::unique_lock lock( m_mutex );
+	for ( auto & b : m_buffers )
+	    buffers.push_back( b.get() );
+    }
+
+    std::vector<TraceBuffer *> closed;
+    for ( TraceBuffer * buffer : buffers )
+    {
+	// the records written before the thread has exited are processed by the call below
+	bool is_closed = buffer->m_closed.load( std::memory_order_acquire );
+	process( *buffer );
+	if ( is_closed )
+	    closed.push_back( buffer );
+    }
+
+    if ( !closed.empty() )
+    {
+	std::unique_lock lock( m_mutex );
+	for ( TraceBuffer * buffer : closed )
+	{
+	    m_buffers.erase( std::find_if( m_buffers.begin(), m_buffers.end(),
+		    [buffer]( const std::unique_ptr<TraceBuffer> & b ) { return b.get() == buffer; } ) );
+	}
+    }
+}
+
+/** Converts the records of the given buffer to issues and sends them to the debug stream.
+  */
+void
+ers::TraceCollector::process( TraceBuffer & buffer )
+{
+    uint64_t tail = buffer.m_tail.load( std::memory_order_relaxed );
+    uint64_t head = buffer.m_head.load( std::memory_order_acquire );
+
+    if ( tail != head )
+    {
+	ers::LocalContext here( ERS_PACKAGE, __FILE__, __LINE__, __PRETTY_FUNCTION__ );
+	ers::RemoteProcessContext process( here.host_name(), here.process_id(), buffer.thread_id(),
+		here.cwd(), here.user_id(), here.user_name(), here.application_name() );
+
+	while ( tail != head )
+	{
+	    uint64_t position = tail % buffer.m_capacity;
+	    const char * record = buffer.m_data.get() + position;
+
+	    TraceBuffer::Header header;
+	    memcpy( &header.id, record, sizeof( header.id ) );
+	    if ( !header.id )
+	    {
+		tail += buffer.m_capacity - position;
+		continue;
+	    }
+	    memcpy( &header, record, sizeof( header ) );
+
+	    const Site * site;
+	    {
+		std::unique_lock lock( m_mutex );
+		site = &m_sites[header.id - 1];
+	    }
+
+	    const char * arguments = record + sizeof( header );
+	    ers::RemoteContext context( site->site->package, site->site->file, site->site->line,
+		    site->site->function, process );
+	    std::unique_ptr<ers::Issue> issue( ers::IssueFactory::instance().create(
+		    ers::Message::get_uid(), context, ers::Severity( ers::Debug, site->site->level ),
+		    system_clock::time_point( std::chrono::duration_cast<system_clock::duration>(
+			    std::chrono::nanoseconds( header.time ) ) ),
+		    format_message( site->format, site->types, arguments, arguments + header.size ),
+		    site->qualifiers, ers::string_map() ) );
+
+	    tail += TraceBuffer::record_size( header.size );
+	    ers::StreamManager::instance().debug( *issue, site->site->level );
+	}
+	buffer.m_tail.store( tail, std::memory_order_release );
+    }
+
+    uint64_t dropped = buffer.m_dropped.exchange( 0, std::memory_order_relaxed );
+    if ( dropped )
+    {
+	std::ostringstream out;
+	out << dropped << " trace record(s) of the thread " << buffer.thread_id()
+	    << " were lost because the trace buffer was full";
+	ers::StreamManager::instance().debug( ers::Message( ERS_HERE, out.str() ), 0 );
+    }
+}
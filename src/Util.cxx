@@ -1,4 +1,9 @@
+#include <ctype.h>
+#include <errno.h>
 #include <stdio.h>
+#include <unistd.h>
+
+#include <sstream>
 
 #include <ers/internal/Util.h>
 #include <ers/internal/macro.h>
@@ -46,5 +51,58 @@ ers::read_from_environment( const char * name, const char * default_value )
     return ( env ? env : default_value);
 }
 
+/** Writes the whole data to the given file descriptor, restarting interrupted system calls.
+  * Gives up silently if the data can not be written.
+  */
+void
+ers::write_all( int fd, const char * data, size_t size )
+{
+    while ( size )
+    {
+	ssize_t n = ::write( fd, data, size );
+	if ( n < 0 )
+	{
+	    if ( errno == EINTR )
+		continue;
+	    return ;
+	}
+	data += n;
+	size -= n;
+    }
+}
 
+/** Converts a size given as a number with an optional K, M or G suffix to bytes.
+  */
+size_t
+ers::parse_size( const std::string & text )
+{
+    std::istringstream in( text );
+    size_t size = 0;
+    char unit = 0;
+    in >> size >> unit;
+    switch ( ::toupper( unit ) )
+    {
+	case 'G': size *= 1024; [[fallthrough]];
+	case 'M': size *= 1024; [[fallthrough]];
+	case 'K': size *= 1024;
+    }
+    return size;
+}
 
+/** Converts a time interval given as a number with an optional s, m, h or d suffix to seconds.
+  */
+std::chrono::seconds
+ers::parse_duration( const std::string & text )
+{
+    std::istringstream in( text );
+    long value = 0;
+    char unit = 0;
+    in >> value >> unit;
+    switch ( ::tolower( unit ) )
+    {
+	case 'd': value *= 24; [[fallthrough]];
+	case 'h': value *= 60; [[fallthrough]];
+	case 'm': value *= 60;
+    }
+    return std::chrono::seconds( value );
+}
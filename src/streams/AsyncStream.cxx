@@ -0,0 +1,211 @@
+/*
+ *  AsyncStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <chrono>
+
+#include <ers/internal/AsyncStream.h>
+#include <ers/internal/Util.h>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::AsyncStream, "async", format )
+
+ERS_DECLARE_ISSUE(	ers,
+			IssuesDropped,
+			count << " issue(s) have been discarded because the asynchronous stream queue was full",
+			((size_t)count) )
+
+namespace
+{
+    const size_t DefaultCapacity = 65536;
+
+    // Gives up waiting for a flush if the queue makes no progress for this time
+    const std::chrono::seconds FlushTimeout( 1 );
+}
+
+/** Constructor that creates a new instance of the asynchronous stream.
+  * \param format comma separated queue capacity and overflow policy
+  */
+ers::AsyncStream::AsyncStream( const std::string & format )
+  : m_head( 0 ),
+    m_size( 0 ),
+    m_reserved( 0 ),
+    m_policy( Drop ),
+    m_dropped( 0 ),
+    m_processed( 0 ),
+    m_flush_requested( 0 ),
+    m_flush_done( 0 ),
+    m_terminated( false )
+{
+    size_t capacity = DefaultCapacity;
+
+    std::vector<std::string> params;
+    ers::tokenize( format, ",", params );
+
+    if ( params.size() > 0 && !params[0].empty() )
+    {
+	std::istringstream in( params[0] );
+        in >> capacity;
+    }
+
+    if ( params.size() > 1 )
+    {
+	if ( params[1] == "block" )
+	    m_policy = Block;
+	else if ( params[1] == "drop_low" )
+	    m_policy = DropLow;
+	else if ( params[1] != "drop" )
+	    ERS_INTERNAL_ERROR( "Unknown overflow policy \"" << params[1] << "\" is given for the async stream, "
+	    	"\"drop\" will be used" )
+    }
+
+    m_queue.resize( capacity ? capacity : 1 );
+    m_thread = std::thread( &ers::AsyncStream::run, this );
+}
+
+ers::AsyncStream::~AsyncStream()
+{
+    {
+	std::unique_lock lock( m_mutex );
+	m_terminated = true;
+	m_not_empty.notify_one();
+	m_not_full.notify_all();
+    }
+    m_thread.join();
+}
+
+bool
+ers::AsyncStream::must_wait( const Issue & issue ) const
+{
+    // An issue reported by one of the chained streams must never wait for itself
+    if ( std::this_thread::get_id() == m_thread.get_id() )
+	return false;
+
+    return ( m_policy == Block || ( m_policy == DropLow && issue.severity() >= ers::Warning ) );
+}
+
+/** Write method
+  * puts a copy of the issue to the queue. If the queue is full the issue
+  * is either discarded or the calling thread waits, depending on the stream configuration.
+  * A slot is claimed before the issue is copied, so a discarded issue is never copied
+  * and the copy is made without holding the queue lock.
+  * \param issue issue to be sent.
+  */
+void
+ers::AsyncStream::write( const Issue & issue )
+{
+    std::unique_lock lock( m_mutex );
+    if ( m_size + m_reserved == m_queue.size() )
+    {
+	if ( !must_wait( issue ) )
+	{
+	    ++m_dropped;
+	    return ;
+	}
+	m_not_full.wait( lock, [this](){ return m_size + m_reserved < m_queue.size() || m_terminated; } );
+	if ( m_terminated )
+	    return ;
+    }
+    ++m_reserved;
+    lock.unlock();
+
+    std::unique_ptr<Issue> copy;
+    try
+    {
+	copy.reset( issue.clone() );
+    }
+    catch( ... )
+    {
+	lock.lock();
+	--m_reserved;
+	m_not_full.notify_one();
+	throw;
+    }
+
+    lock.lock();
+    --m_reserved;
+    m_queue[( m_head + m_size++ ) % m_queue.size()] = std::move( copy );
+    m_not_empty.notify_one();
+}
+
+/** Waits until all the issues from the queue have been passed to the chained streams
+  * and flushes them. The waiting is abandoned if the queue makes no progress for a second.
+  */
+void
+ers::AsyncStream::flush( )
+{
+    if ( std::this_thread::get_id() == m_thread.get_id() )
+	return ;
+
+    std::unique_lock lock( m_mutex );
+    unsigned long request = ++m_flush_requested;
+    m_not_empty.notify_one();
+
+    size_t processed = m_processed;
+    while ( m_flush_done < request )
+    {
+	if ( !m_progress.wait_for( lock, FlushTimeout, [this, request](){ return m_flush_done >= request; } ) )
+	{
+	    if ( processed == m_processed )
+		return ;
+	    processed = m_processed;
+	}
+    }
+}
+
+void
+ers::AsyncStream::run( )
+{
+    std::unique_lock lock( m_mutex );
+    while ( true )
+    {
+	m_not_empty.wait( lock, [this](){
+		return m_size || m_terminated || m_flush_done < m_flush_requested; } );
+
+	if ( !m_size )
+	{
+	    if ( m_flush_done < m_flush_requested )
+	    {
+		unsigned long request = m_flush_requested;
+		lock.unlock();
+		chained().flush();
+		lock.lock();
+		m_flush_done = request;
+		m_progress.notify_all();
+		continue;
+	    }
+	    break;
+	}
+
+	std::unique_ptr<Issue> issue = std::move( m_queue[m_head] );
+	m_head = ( m_head + 1 ) % m_queue.size();
+	--m_size;
+	size_t dropped = m_dropped;
+	m_dropped = 0;
+	m_not_full.notify_one();
+	lock.unlock();
+
+	try
+	{
+	    if ( dropped )
+	    {
+		ers::IssuesDropped notice( ERS_HERE, dropped );
+		notice.set_severity( issue->severity() );
+		chained().write( notice );
+	    }
+	    chained().write( *issue );
+	}
+	catch( std::exception & ex )
+	{
+	    ERS_INTERNAL_ERROR( "Chained stream has thrown an exception: " << ex.what() )
+	}
+	issue.reset();
+
+	lock.lock();
+	++m_processed;
+	m_progress.notify_all();
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ *  BinaryFileStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ers/BinaryStreamOutput.h>
+#include <ers/SampleIssues.h>
+#include <ers/internal/BinaryFileStream.h>
+#include <ers/internal/Util.h>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::BinaryFileStream, "binfile", file_name )
+
+/** Constructor that creates a new instance of the binary file stream.
+  * \param file_name name of the output file
+  */
+ers::BinaryFileStream::BinaryFileStream( const std::string & file_name )
+  : m_fd( ::open( file_name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 ) )
+{
+    if ( m_fd < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+
+    struct stat st;
+    if ( !::fstat( m_fd, &st ) && !st.st_size )
+    {
+	ers::write_all( m_fd, BinaryStreamOutput::Magic, sizeof( BinaryStreamOutput::Magic ) );
+    }
+}
+
+ers::BinaryFileStream::~BinaryFileStream()
+{
+    ::close( m_fd );
+}
+
+/** Write method
+  * encodes the issue and writes it to the file.
+  * \param issue issue to be sent.
+  */
+void
+ers::BinaryFileStream::write( const Issue & issue )
+{
+    thread_local std::string record;
+
+    record.clear();
+    BinaryStreamOutput::encode( record, issue );
+    ers::write_all( m_fd, record.data(), record.size() );
+
+    chained().write( issue );
+}
@@ -0,0 +1,189 @@
+/*
+ *  BufferedFileStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <ers/SampleIssues.h>
+#include <ers/internal/BufferedFileStream.h>
+#include <ers/internal/StandardStream.h>
+#include <ers/internal/Util.h>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::BufferedFileStream, "bfile", format )
+
+namespace
+{
+    const size_t DefaultBufferSize = 1024*1024;
+
+    // The crash handler gives up writing the buffer if it is locked for longer than this
+    const std::chrono::milliseconds FlushTimeout( 500 );
+}
+
+/** Constructor that creates a new instance of the buffered file stream.
+  * \param format comma separated file name, buffer size, flush interval and flush severity
+  */
+ers::BufferedFileStream::BufferedFileStream( const std::string & format )
+  : m_fd( -1 ),
+    m_buffer_size( DefaultBufferSize ),
+    m_flush_interval( 200 ),
+    m_flush_severity( ers::Warning ),
+    m_terminated( false )
+{
+    std::vector<std::string> params;
+    ers::tokenize( format, ",", params );
+
+    std::string file_name = params.size() > 0 ? params[0] : "";
+
+    if ( params.size() > 1 && !params[1].empty() )
+    {
+	m_buffer_size = ers::parse_size( params[1] );
+    }
+
+    if ( params.size() > 2 && !params[2].empty() )
+    {
+	std::istringstream in( params[2] );
+	long ms = 0;
+	in >> ms;
+	m_flush_interval = std::chrono::milliseconds( ms );
+    }
+
+    if ( params.size() > 3 && !params[3].empty() )
+    {
+	try {
+	    ers::parse( boost::algorithm::to_upper_copy( params[3] ), m_flush_severity );
+	}
+	catch ( ers::Issue & ) {
+	    ERS_INTERNAL_ERROR( "Unknown severity \"" << params[3] << "\" is given for the bfile stream, "
+	    	"\"WARNING\" will be used" )
+	}
+    }
+
+    m_fd = ::open( file_name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+    if ( m_fd < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+
+    m_buffer.reserve( m_buffer_size );
+    m_output.reserve( m_buffer_size );
+
+    if ( m_flush_interval.count() > 0 )
+    {
+	m_thread = std::thread( &ers::BufferedFileStream::run, this );
+    }
+}
+
+ers::BufferedFileStream::~BufferedFileStream()
+{
+    if ( m_thread.joinable() )
+    {
+	{
+	    std::unique_lock lock( m_timer_mutex );
+	    m_terminated = true;
+	    m_timer.notify_one();
+	}
+	m_thread.join();
+    }
+    write_buffer( std::chrono::milliseconds::max() );
+    ::close( m_fd );
+}
+
+bool
+ers::BufferedFileStream::needsStack() const
+{
+    return Configuration::instance().verbosity_level() > 3;
+}
+
+/** Writes the content of the buffer to the file. The buffer is swapped with an
+  * empty one, so that new issues can be added to it while the old ones are written.
+  * \param timeout maximum time to wait for another thread which is using the buffer
+  * \return false if the buffer could not be locked within the given time
+  */
+bool
+ers::BufferedFileStream::write_buffer( const std::chrono::milliseconds & timeout )
+{
+    std::unique_lock output_lock( m_output_mutex, std::defer_lock );
+    if ( timeout == std::chrono::milliseconds::max() )
+	output_lock.lock();
+    else if ( !output_lock.try_lock_for( timeout ) )
+	return false;
+
+    {
+	std::unique_lock buffer_lock( m_buffer_mutex, std::defer_lock );
+	if ( timeout == std::chrono::milliseconds::max() )
+	    buffer_lock.lock();
+	else if ( !buffer_lock.try_lock_for( timeout ) )
+	    return false;
+
+	m_output.swap( m_buffer );
+    }
+
+    ers::write_all( m_fd, m_output.data(), m_output.size() );
+    m_output.clear();
+    return true;
+}
+
+/** Write method
+  * adds the issue to the buffer and writes the buffer to the file if it is full
+  * or if the issue severity is high enough.
+  * \param issue issue to be sent.
+  */
+void
+ers::BufferedFileStream::write( const Issue & issue )
+{
+    thread_local std::string line;
+    thread_local StringStreamBuffer line_buffer( line );
+    thread_local std::ostream out( &line_buffer );
+
+    line.clear();
+    out.clear();
+    StandardStreamOutput::println( out, issue, Configuration::instance().verbosity_level() );
+
+    bool full;
+    {
+	std::unique_lock lock( m_buffer_mutex );
+	m_buffer.append( line );
+	full = m_buffer.size() >= m_buffer_size;
+    }
+
+    if ( full || issue.severity() >= m_flush_severity )
+    {
+	write_buffer( std::chrono::milliseconds::max() );
+    }
+
+    chained().write( issue );
+}
+
+/** Writes buffered issues to the file. This function is called at exit and by the crash
+  * handlers. After a crash it does not wait forever if the buffer is used by another thread,
+  * since this may be the crashing one.
+  */
+void
+ers::BufferedFileStream::flush( )
+{
+    write_buffer( Context::is_crashing() ? FlushTimeout : std::chrono::milliseconds::max() );
+    chained().flush();
+}
+
+void
+ers::BufferedFileStream::run( )
+{
+    std::unique_lock lock( m_timer_mutex );
+    while ( !m_terminated )
+    {
+	m_timer.wait_for( lock, m_flush_interval );
+	if ( m_terminated )
+	    break;
+
+	lock.unlock();
+	write_buffer( std::chrono::milliseconds::max() );
+	lock.lock();
+    }
+}
@@ -11,7 +11,6 @@
 #include <ers/internal/FilterStream.h>
 #include <ers/internal/Util.h>
 #include <ers/StreamFactory.h>
-#include <algorithm>
 
 ERS_REGISTER_OUTPUT_STREAM( ers::FilterStream, "filter", format )
 
@@ -32,9 +31,9 @@ ers::FilterStream::FilterStream( const std::string & format )
     for( size_t i = 0; i < tokens.size(); i++ )
     {
     	if ( !tokens[i].empty() && tokens[i][0] == NOT )
-            m_exclude.push_back( tokens[i].substr( 1 ) );
+            m_exclude.insert( QualifierSet::symbol( tokens[i].substr( 1 ) ) );
         else
-            m_include.push_back( tokens[i] );
+            m_include.insert( QualifierSet::symbol( tokens[i] ) );
     }
 }
 
@@ -47,25 +46,32 @@ ers::FilterStream::FilterStream( const std::string & format )
 bool
 ers::FilterStream::is_accepted( const ers::Issue & issue )
 {
-    const std::vector<std::string> & qualifiers = issue.qualifiers( );
-               
-    std::vector<std::string>::const_iterator it;
-    for( it = m_exclude.begin(); it != m_exclude.end(); ++it )
+    if ( issue.qualifier_set( ).incomplete() )
     {
-	std::vector<std::string>::const_iterator conflict = std::find( qualifiers.begin(), qualifiers.end(), *it );
-	if ( conflict != qualifiers.end() )
+	// the qualifiers of a received issue may have been added to the table by this filter later
+	QualifierSet known;
+	for ( const std::string & q : issue.qualifiers() )
 	{
-	    return false;
+	    QualifierSet::Symbol symbol = QualifierSet::find( q );
+	    if ( symbol != QualifierSet::NoSymbol )
+		known.insert( symbol );
 	}
+	return is_accepted( known );
+    }
+    return is_accepted( issue.qualifier_set( ) );
+}
+
+bool
+ers::FilterStream::is_accepted( const QualifierSet & qualifiers ) const
+{
+    if ( qualifiers.intersects( m_exclude ) )
+    {
+	return false;
     }
     
-    for( it = m_include.begin(); it != m_include.end(); ++it )
+    if ( qualifiers.intersects( m_include ) )
     {
-	std::vector<std::string>::const_iterator match = std::find( qualifiers.begin(), qualifiers.end(), *it );
-	if ( match != qualifiers.end() )
-	{
-            return true;
-	}
+	return true;
     }
 
     return m_include.empty(); 
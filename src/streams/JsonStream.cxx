@@ -0,0 +1,354 @@
+/*
+ *  JsonStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <iterator>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#include <ers/SampleIssues.h>
+#include <ers/internal/JsonStream.h>
+#include <ers/internal/Util.h>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::JsonStream, "jsonl", format )
+
+namespace
+{
+    struct Field
+    {
+	enum Type { Time, Severity, Class, Message, Application, Host, Pid, Tid, User, Uid, Cwd,
+		    Package, File, Line, Function, Qualifiers, Parameters, Stack, Cause };
+    };
+
+    const char * const FieldNames[] = { "time", "severity", "class", "message", "application", "host",
+	"pid", "tid", "user", "uid", "cwd", "package", "file", "line", "function", "qualifiers",
+	"parameters", "stack", "cause" };
+
+    inline bool needs_escape( unsigned char c )
+    {
+	return c < 0x20 || c == '"' || c == '\\';
+    }
+
+    /** Returns the position of the first character in [begin,end) which has to be escaped, or end.
+      * 16 (or 8 if SSE2 is not available) characters are checked at once.
+      */
+    const char * find_escape( const char * begin, const char * end )
+    {
+#if defined( __SSE2__ )
+	const __m128i quote = _mm_set1_epi8( '"' );
+	const __m128i backslash = _mm_set1_epi8( '\\' );
+	const __m128i control = _mm_set1_epi8( 0x1f );
+	for ( ; end - begin >= 16; begin += 16 )
+	{
+	    __m128i c = _mm_loadu_si128( reinterpret_cast<const __m128i *>( begin ) );
+	    __m128i m = _mm_or_si128(
+		    _mm_or_si128( _mm_cmpeq_epi8( c, quote ), _mm_cmpeq_epi8( c, backslash ) ),
+		    _mm_cmpeq_epi8( _mm_min_epu8( c, control ), c ) );
+	    if ( int mask = _mm_movemask_epi8( m ) )
+		return begin + __builtin_ctz( mask );
+	}
+#else
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t highs = 0x8080808080808080ULL;
+	for ( ; end - begin >= 8; begin += 8 )
+	{
+	    uint64_t c;
+	    memcpy( &c, begin, 8 );
+	    uint64_t q = c ^ ( ones * '"' );
+	    uint64_t b = c ^ ( ones * '\\' );
+	    // the high bit of a byte is set if it is a control character, a quote or a backslash
+	    // (or follows such a byte, which is checked character by character)
+	    if ( ( ( ( c - ones * 0x20 ) & ~c ) | ( ( q - ones ) & ~q ) | ( ( b - ones ) & ~b ) ) & highs )
+	    {
+		for ( int i = 0; i < 8; ++i )
+		    if ( needs_escape( begin[i] ) )
+			return begin + i;
+	    }
+	}
+#endif
+	for ( ; begin != end; ++begin )
+	    if ( needs_escape( *begin ) )
+		return begin;
+	return end;
+    }
+
+    void append_escaped( std::string & out, const char * text, size_t size )
+    {
+	static const char hex[] = "0123456789abcdef";
+
+	const char * end = text + size;
+	while ( text != end )
+	{
+	    const char * p = find_escape( text, end );
+	    out.append( text, p - text );
+	    if ( p == end )
+		break;
+
+	    switch ( *p )
+	    {
+		case '"':  out.append( "\\\"", 2 ); break;
+		case '\\': out.append( "\\\\", 2 ); break;
+		case '\n': out.append( "\\n", 2 ); break;
+		case '\t': out.append( "\\t", 2 ); break;
+		case '\r': out.append( "\\r", 2 ); break;
+		case '\b': out.append( "\\b", 2 ); break;
+		case '\f': out.append( "\\f", 2 ); break;
+		default:
+		{
+		    char u[] = { '\\', 'u', '0', '0', hex[( *p >> 4 ) & 0xf], hex[*p & 0xf] };
+		    out.append( u, sizeof( u ) );
+		}
+	    }
+	    text = p + 1;
+	}
+    }
+
+    inline void append_string( std::string & out, const char * text, size_t size )
+    {
+	out.push_back( '"' );
+	append_escaped( out, text, size );
+	out.push_back( '"' );
+    }
+
+    inline void append_string( std::string & out, const std::string & text )
+    {
+	append_string( out, text.data(), text.size() );
+    }
+
+    inline void append_string( std::string & out, const char * text )
+    {
+	append_string( out, text, strlen( text ) );
+    }
+
+    /** Appends the time in the ISO 8601 format with microseconds precision. The text of
+      * the last second seen by the current thread is cached.
+      */
+    void append_time( std::string & out, const system_clock::time_point & time )
+    {
+	thread_local std::time_t cached_second = -1;
+	thread_local char prefix[32];
+	thread_local size_t prefix_size = 0;
+
+	long long us = std::chrono::duration_cast<std::chrono::microseconds>( time.time_since_epoch() ).count();
+	std::time_t second = us / 1000000;
+	long long fraction = us % 1000000;
+	if ( fraction < 0 )
+	{
+	    fraction += 1000000;
+	    --second;
+	}
+
+	if ( second != cached_second )
+	{
+	    std::tm tm;
+	    gmtime_r( &second, &tm );
+	    prefix_size = std::strftime( prefix, sizeof( prefix ), "\"%Y-%m-%dT%H:%M:%S.", &tm );
+	    cached_second = second;
+	}
+
+	char digits[8] = { '0', '0', '0', '0', '0', '0', 'Z', '"' };
+	for ( int i = 5; fraction; --i, fraction /= 10 )
+	    digits[i] = '0' + fraction % 10;
+
+	out.append( prefix, prefix_size );
+	out.append( digits, sizeof( digits ) );
+    }
+
+    template <class T>
+    inline void append_number( std::string & out, T value )
+    {
+	char buffer[24];
+	out.append( buffer, std::to_chars( buffer, buffer + sizeof( buffer ), value ).ptr );
+    }
+}
+
+/** Constructor that creates a new instance of the JSON stream.
+  * \param format comma separated output name followed by the names of the fields to be printed
+  */
+ers::JsonStream::JsonStream( const std::string & format )
+  : m_fd( -1 ),
+    m_close( false )
+{
+    std::vector<std::string> params;
+    ers::tokenize( format, ",", params );
+
+    std::string output = params.size() > 0 ? params[0] : "stdout";
+    if ( output == "stdout" || output.empty() )
+    {
+	m_fd = 1;
+    }
+    else if ( output == "stderr" )
+    {
+	m_fd = 2;
+    }
+    else
+    {
+	m_fd = ::open( output.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+	if ( m_fd < 0 )
+	{
+	    throw ers::CantOpenFile( ERS_HERE, output.c_str() );
+	}
+	m_close = true;
+    }
+
+    for ( size_t i = 1; i < params.size(); ++i )
+    {
+	const char * const * f = std::find_if( std::begin( FieldNames ), std::end( FieldNames ),
+		[&params, i]( const char * name ) { return params[i] == name; } );
+	if ( f == std::end( FieldNames ) )
+	{
+	    ERS_INTERNAL_ERROR( "Unknown field \"" << params[i] << "\" is given for the jsonl stream" )
+	    continue;
+	}
+	m_fields.push_back( f - std::begin( FieldNames ) );
+    }
+
+    if ( m_fields.empty() )
+    {
+	for ( int f = Field::Time; f <= Field::Cause; ++f )
+	    if ( f != Field::Stack )
+		m_fields.push_back( f );
+    }
+}
+
+ers::JsonStream::~JsonStream()
+{
+    if ( m_close )
+    {
+	::close( m_fd );
+    }
+}
+
+bool
+ers::JsonStream::needsStack() const
+{
+    return std::find( m_fields.begin(), m_fields.end(), Field::Stack ) != m_fields.end();
+}
+
+void
+ers::JsonStream::print( std::string & out, const Issue & issue ) const
+{
+    out.push_back( '{' );
+    bool first = true;
+    for ( int field : m_fields )
+    {
+	if ( field == Field::Cause && !issue.cause() )
+	    continue;
+
+	if ( !first )
+	    out.push_back( ',' );
+	first = false;
+	out.push_back( '"' );
+	out.append( FieldNames[field] );
+	out.append( "\":", 2 );
+
+	const Context & context = issue.context();
+	switch ( field )
+	{
+	    case Field::Time:
+		append_time( out, issue.ptime() );
+		break;
+	    case Field::Severity:
+	    {
+		out.push_back( '"' );
+		out.append( ers::to_string( issue.severity().type ) );
+		if ( issue.severity().type == ers::Debug )
+		{
+		    out.push_back( '_' );
+		    append_number( out, issue.severity().rank );
+		}
+		out.push_back( '"' );
+		break;
+	    }
+	    case Field::Class:		append_string( out, issue.get_class_name() ); break;
+	    case Field::Message:	append_string( out, issue.message() ); break;
+	    case Field::Application:	append_string( out, context.application_name() ); break;
+	    case Field::Host:		append_string( out, context.host_name() ); break;
+	    case Field::Pid:		append_number( out, context.process_id() ); break;
+	    case Field::Tid:		append_number( out, context.thread_id() ); break;
+	    case Field::User:		append_string( out, context.user_name() ); break;
+	    case Field::Uid:		append_number( out, context.user_id() ); break;
+	    case Field::Cwd:		append_string( out, context.cwd() ); break;
+	    case Field::Package:	append_string( out, context.package_name() ); break;
+	    case Field::File:		append_string( out, context.file_name() ); break;
+	    case Field::Line:		append_number( out, context.line_number() ); break;
+	    case Field::Function:	append_string( out, context.function_name() ); break;
+	    case Field::Qualifiers:
+	    {
+		out.push_back( '[' );
+		for ( size_t i = 0; i < issue.qualifiers().size(); ++i )
+		{
+		    if ( i )
+			out.push_back( ',' );
+		    append_string( out, issue.qualifiers()[i] );
+		}
+		out.push_back( ']' );
+		break;
+	    }
+	    case Field::Parameters:
+	    {
+		out.push_back( '{' );
+		bool first_parameter = true;
+		for ( const auto & p : issue.parameters() )
+		{
+		    if ( !first_parameter )
+			out.push_back( ',' );
+		    first_parameter = false;
+		    append_string( out, p.first );
+		    out.push_back( ':' );
+		    append_string( out, p.second );
+		}
+		out.push_back( '}' );
+		break;
+	    }
+	    case Field::Stack:
+	    {
+		out.push_back( '[' );
+		const std::vector<std::string_view> & stack = context.stack_view();
+		for ( size_t i = 0; i < stack.size(); ++i )
+		{
+		    if ( i )
+			out.push_back( ',' );
+		    append_string( out, stack[i].data(), stack[i].size() );
+		}
+		out.push_back( ']' );
+		break;
+	    }
+	    case Field::Cause:
+		print( out, *issue.cause() );
+		break;
+	}
+    }
+    out.push_back( '}' );
+}
+
+/** Write method
+  * prints the issue as a JSON object to the output using a single system call.
+  * \param issue issue to be sent.
+  */
+void
+ers::JsonStream::write( const Issue & issue )
+{
+    thread_local std::string line;
+
+    line.clear();
+    print( line, issue );
+    line.push_back( '\n' );
+    ers::write_all( m_fd, line.data(), line.size() );
+
+    chained().write( issue );
+}
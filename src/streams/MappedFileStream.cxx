@@ -0,0 +1,178 @@
+/*
+ *  MappedFileStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <new>
+
+#include <ers/SampleIssues.h>
+#include <ers/internal/MappedFileStream.h>
+#include <ers/internal/StandardStream.h>
+#include <ers/internal/Util.h>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::MappedFileStream, "mmapfile", format )
+
+namespace
+{
+    const size_t DefaultCapacity = 64*1024*1024;
+    const size_t DataOffset = 64;
+
+    static_assert( sizeof( ers::MappedFileHeader ) <= DataOffset, "file header does not fit" );
+    static_assert( std::atomic<uint64_t>::is_always_lock_free, "lock-free 64 bits atomics are required" );
+}
+
+/** Constructor that creates a new instance of the memory mapped file stream.
+  * \param format comma separated file name and file size
+  */
+ers::MappedFileStream::MappedFileStream( const std::string & format )
+  : m_fd( -1 ),
+    m_capacity( DefaultCapacity ),
+    m_data( 0 ),
+    m_header( 0 )
+{
+    std::vector<std::string> params;
+    ers::tokenize( format, ",", params );
+
+    std::string file_name = params.size() > 0 ? params[0] : "";
+
+    if ( params.size() > 1 && !params[1].empty() )
+    {
+	m_capacity = ers::parse_size( params[1] );
+    }
+
+    if ( m_capacity < DataOffset + MappedRecordHeader::record_size( 0 ) )
+    {
+	ERS_INTERNAL_ERROR( "File size \"" << params[1] << "\" is too small for the mmapfile stream, "
+		"the default value will be used" )
+	m_capacity = DefaultCapacity;
+    }
+
+    // the file written by the previous run is kept for the post-mortem analysis
+    std::string previous = file_name + ".1";
+    if ( ::rename( file_name.c_str(), previous.c_str() ) && errno != ENOENT )
+    {
+	throw ers::CantOpenFile( ERS_HERE, previous.c_str() );
+    }
+
+    // the new file must be filled with zeros, which mark the free space
+    m_fd = ::open( file_name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644 );
+    if ( m_fd < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+
+    // allocate the disk blocks now, so that writing to the mapping can not fail with SIGBUS later
+    if ( ::posix_fallocate( m_fd, 0, m_capacity ) )
+    {
+	::close( m_fd );
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+
+    void * data = ::mmap( 0, m_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+    if ( data == MAP_FAILED )
+    {
+	::close( m_fd );
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+
+    m_data = static_cast<char *>( data );
+    m_header = new ( m_data ) MappedFileHeader;
+    m_header->capacity = m_capacity;
+    m_header->data_offset = DataOffset;
+    m_header->tail.store( DataOffset, std::memory_order_relaxed );
+    m_header->dropped.store( 0, std::memory_order_relaxed );
+    // the magic is set last, so a reader never sees a header which is not initialised
+    std::atomic_thread_fence( std::memory_order_release );
+    memcpy( m_header->magic, MappedFileHeader::Magic, sizeof( m_header->magic ) );
+}
+
+ers::MappedFileStream::~MappedFileStream()
+{
+    ::munmap( m_data, m_capacity );
+    ::close( m_fd );
+}
+
+bool
+ers::MappedFileStream::needsStack() const
+{
+    return Configuration::instance().verbosity_level() > 3;
+}
+
+/** Reserves a record for a text of the given size. The record is claimed by setting its size, which
+  * is zero for the free space, with a single atomic operation, so that a reader can find the next record
+  * even if the writer never completes this one. The tail is advanced afterwards by the writer or by any
+  * other thread which finds the record already claimed.
+  * \return the reserved record or 0 if there is no space for it
+  */
+ers::MappedRecordHeader *
+ers::MappedFileStream::reserve( uint32_t text_size )
+{
+    uint64_t size = MappedRecordHeader::record_size( text_size );
+    uint64_t offset = m_header->tail.load( std::memory_order_acquire );
+
+    while ( offset + sizeof( MappedRecordHeader ) <= m_capacity )
+    {
+	MappedRecordHeader * record = reinterpret_cast<MappedRecordHeader *>( m_data + offset );
+
+	// the first record which does not fit marks the rest of the file as unused
+	bool fits = offset + size <= m_capacity;
+	uint32_t claimed = 0;
+	if ( record->size.compare_exchange_strong( claimed, fits ? text_size : MappedRecordHeader::PaddingSize,
+		std::memory_order_relaxed ) )
+	{
+	    if ( !fits )
+	    {
+		record->state.store( MappedRecordHeader::Padding, std::memory_order_release );
+		m_header->tail.compare_exchange_strong( offset, m_capacity, std::memory_order_release );
+		return 0;
+	    }
+	    m_header->tail.compare_exchange_strong( offset, offset + size, std::memory_order_release );
+	    return record;
+	}
+
+	uint64_t next = claimed == MappedRecordHeader::PaddingSize
+		? m_capacity : offset + MappedRecordHeader::record_size( claimed );
+	if ( m_header->tail.compare_exchange_strong( offset, next, std::memory_order_acq_rel ) )
+	    offset = next;
+    }
+    return 0;
+}
+
+/** Write method
+  * reserves space for the issue text in the file and copies the text there.
+  * \param issue issue to be sent.
+  */
+void
+ers::MappedFileStream::write( const Issue & issue )
+{
+    thread_local std::string line;
+    thread_local StringStreamBuffer line_buffer( line );
+    thread_local std::ostream out( &line_buffer );
+
+    line.clear();
+    out.clear();
+    StandardStreamOutput::println( out, issue, Configuration::instance().verbosity_level() );
+
+    MappedRecordHeader * record = reserve( line.size() );
+
+    if ( record )
+    {
+	memcpy( reinterpret_cast<char *>( record + 1 ), line.data(), line.size() );
+	record->state.store( MappedRecordHeader::Committed, std::memory_order_release );
+    }
+    else
+    {
+	m_header->dropped.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    chained().write( issue );
+}
@@ -7,6 +7,11 @@
  *
  */
 
+#include <string.h>
+
+#include <string_view>
+
+#include <ers/CallSite.h>
 #include <ers/internal/RFilterStream.h>
 #include <ers/internal/Util.h>
 #include <ers/StreamFactory.h>
@@ -17,8 +22,65 @@ namespace
 {
     const char NOT = '!';
     const char * const SEPARATORS = ",";
+
+    /** Detects back references and subexpression calls, e.g. (?1), (?-1), (?R) or (?&name),
+      * whose numbers or names would refer to the wrong subexpressions or to the whole
+      * combined expression if the expression is combined with the others. */
+    const boost::regex BACK_REFERENCE( "\\\\(?:[1-9]|g|k)|\\(\\?P=|\\(\\?(?:[-+]?\\d|R|&|P>)" );
 } // anonymous namespace
 
+/** Compiles the given expressions into a single alternation. An invalid expression
+  * throws the same exception as it did when the expressions were compiled one by one.
+  */
+void
+ers::RFilterStream::Matcher::compile( const std::vector<std::string> & patterns )
+{
+    std::string combined;
+    for( size_t i = 0; i < patterns.size(); i++ )
+    {
+        boost::regex regex( patterns[i] );
+        m_empty = false;
+        if ( boost::regex_search( patterns[i], BACK_REFERENCE ) )
+        {
+            m_separate.push_back( regex );
+            continue;
+        }
+        if ( !combined.empty() )
+            combined += '|';
+        combined += "(?:" + patterns[i] + ")";
+    }
+
+    if ( combined.empty() )
+        return ;
+
+    try {
+        m_combined.assign( combined );
+    }
+    catch( boost::regex_error & ) {
+        // e.g. the same named subexpression is used by several expressions
+        for( size_t i = 0; i < patterns.size(); i++ )
+            if ( !boost::regex_search( patterns[i], BACK_REFERENCE ) )
+                m_separate.push_back( boost::regex( patterns[i] ) );
+    }
+}
+
+bool
+ers::RFilterStream::Matcher::search( const char * begin, const char * end ) const
+{
+    if ( m_empty )
+        return false;
+
+    if ( !m_combined.empty() && boost::regex_search( begin, end, m_combined ) )
+        return true;
+
+    std::vector<boost::regex>::const_iterator it;
+    for( it = m_separate.begin(); it != m_separate.end(); ++it )
+        if ( boost::regex_search( begin, end, *it ) )
+            return true;
+
+    return false;
+}
+
 
 
 /** Constructor 
@@ -31,13 +93,16 @@ ers::RFilterStream::RFilterStream( const std::string & format )
 {
     std::vector<std::string> tokens;
     ers::tokenize( format, SEPARATORS, tokens );
+    std::vector<std::string> include, exclude;
     for( size_t i = 0; i < tokens.size(); i++ )
     {
         if ( !tokens[i].empty() && tokens[i][0] == NOT ) 
-            m_regExclude.push_back( boost::regex(tokens[i].substr( 1 )) );
+            exclude.push_back( tokens[i].substr( 1 ) );
         else
-            m_regInclude.push_back( boost::regex(tokens[i]) );
+            include.push_back( tokens[i] );
     }
+    m_regInclude.compile( include );
+    m_regExclude.compile( exclude );
 }
 
 
@@ -50,40 +115,71 @@ bool
 ers::RFilterStream::is_accepted( const ers::Issue & issue )
 {
   // Get the function name that will be the input of the pattern search
-  std::string s = issue.context().function_name();
-  // Remove the function arguments, which could lead to fake matches
-  s = s.substr(0,s.find_first_of('('));   
-  
+  // without the function arguments, which could lead to fake matches
+  const char * function = issue.context().function_name();
+  const ers::CallSite * site = issue.context().call_site();
+  const QualifierSet & qualifiers = issue.qualifier_set( );
+
+  // The qualifiers which have no symbols are not represented by the set, so it can not be a cache key
+  if ( qualifiers.incomplete() )
+    return evaluate( function, function + strcspn( function, "(" ), issue );
+
+  // The call site identifier is checked first, so the function name is parsed only by the cache misses
+  const char * function_end = site ? 0 : function + strcspn( function, "(" );
+  size_t hash = ( site ? site->id() * 0xC4CEB9FE1A85EC53ULL
+                       : std::hash<std::string_view>()( std::string_view( function, function_end - function ) ) )
+              ^ ( qualifiers.hash() * 0x9E3779B97F4A7C15ULL );
+  Shard & shard = m_shards[hash & ( ( 1 << ShardBits ) - 1 )];
+  Verdict & verdict = shard.m_verdicts[( hash >> ShardBits ) % ShardSize];
+
+  {
+    std::unique_lock<std::mutex> lock( shard.m_mutex );
+    if ( verdict.m_valid && verdict.m_qualifiers == qualifiers
+      && ( site ? verdict.m_site == site->id()
+                : !verdict.m_site && verdict.m_function.compare( 0, std::string::npos, function, function_end - function ) == 0 ) )
+      return verdict.m_accepted;
+  }
+
+  if ( site )
+    function_end = function + strcspn( function, "(" );
+
+  bool accepted = evaluate( function, function_end, issue );
+
+  std::unique_lock<std::mutex> lock( shard.m_mutex );
+  verdict.m_site = site ? site->id() : 0;
+  if ( site )
+    verdict.m_function.clear();
+  else
+    verdict.m_function.assign( function, function_end );
+  verdict.m_qualifiers = qualifiers;
+  verdict.m_accepted = accepted;
+  verdict.m_valid = true;
+  return accepted;
+}
+
+bool
+ers::RFilterStream::evaluate( const char * function, const char * function_end, const ers::Issue & issue ) const
+{
   const std::vector<std::string> & qualifiers = issue.qualifiers( );
-  std::vector<boost::regex>::const_iterator it;
+  std::vector<std::string>::const_iterator it;
 
   // Check excluded matches 
-  for( it = m_regExclude.begin(); it != m_regExclude.end(); ++it )
-  {
-    // 1. Check against function name
-    if (boost::regex_search(s, *it))
-      return false;
+  // 1. Check against function name
+  if ( m_regExclude.search( function, function_end ) )
+    return false;
     
-    // 2. Check against qualifiers
-    std::vector<std::string>::const_iterator ko;
-    for ( ko=qualifiers.begin(); ko<qualifiers.end(); ko++)
-      if ( boost::regex_search(*ko,*it) ) 
-        return false;
-  }
+  // 2. Check against qualifiers
+  for ( it = qualifiers.begin(); it != qualifiers.end(); ++it )
+    if ( m_regExclude.search( it->data(), it->data() + it->size() ) )
+      return false;
 
   // Check included matches (function name, then qualifiers)
-  for( it = m_regInclude.begin(); it != m_regInclude.end(); ++it )
-  {
-    // 1. Check against function name
-    if (boost::regex_search(s, *it))
-      return true;
+  if ( m_regInclude.search( function, function_end ) )
+    return true;
    
-    // 2. Check against qualifiers
-    std::vector<std::string>::const_iterator ok;
-    for (ok=qualifiers.begin(); ok<qualifiers.end(); ok++)
-      if ( boost::regex_search(*ok,*it) )
-        return true;
-  }
+  for ( it = qualifiers.begin(); it != qualifiers.end(); ++it )
+    if ( m_regInclude.search( it->data(), it->data() + it->size() ) )
+      return true;
 
   return false; //m_regInclude.empty();
 }
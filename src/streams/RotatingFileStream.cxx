@@ -0,0 +1,332 @@
+/*
+ *  RotatingFileStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <map>
+#include <vector>
+
+#include <ers/SampleIssues.h>
+#include <ers/internal/RotatingFileStream.h>
+#include <ers/internal/StandardStream.h>
+#include <ers/internal/Util.h>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::RotatingFileStream, "rfile", format )
+
+namespace
+{
+    const size_t DefaultMaxSize = 256*1024*1024;
+    const size_t DefaultKeep = 10;
+
+    /** Returns names of the existing segments of the given file ordered by their sequence numbers.
+      * A segment is a file called <name>.<N> or <name>.<N>.gz, the latter being a compressed one.
+      */
+    std::map<unsigned long, std::vector<std::string>> list_segments( const std::string & file_name )
+    {
+	std::string::size_type pos = file_name.rfind( '/' );
+	std::string dir = pos == std::string::npos ? "." : pos == 0 ? "/" : file_name.substr( 0, pos );
+	std::string prefix = ( pos == std::string::npos ? file_name : file_name.substr( pos + 1 ) ) + '.';
+
+	std::map<unsigned long, std::vector<std::string>> segments;
+	DIR * d = ::opendir( dir.c_str() );
+	if ( !d )
+	    return segments;
+
+	while ( struct dirent * e = ::readdir( d ) )
+	{
+	    const char * name = e->d_name;
+	    if ( strncmp( name, prefix.c_str(), prefix.size() ) )
+		continue;
+
+	    const char * number = name + prefix.size();
+	    char * end;
+	    unsigned long sequence = strtoul( number, &end, 10 );
+	    if ( end == number || !isdigit( *number ) || ( *end && strcmp( end, ".gz" ) ) )
+		continue;
+
+	    segments[sequence].push_back( file_name + '.' + number );
+	}
+	::closedir( d );
+	return segments;
+    }
+}
+
+/** Constructor that creates a new instance of the rotating file stream.
+  * \param format comma separated file name, maximum file size, number of old files to keep and maximum file age
+  */
+ers::RotatingFileStream::RotatingFileStream( const std::string & format )
+  : m_max_size( DefaultMaxSize ),
+    m_keep( DefaultKeep ),
+    m_max_age( 0 ),
+    m_fd( -1 ),
+    m_size( 0 ),
+    m_sequence( 0 ),
+    m_terminated( false )
+{
+    std::vector<std::string> params;
+    ers::tokenize( format, ",", params );
+
+    m_file_name = params.size() > 0 ? params[0] : "";
+
+    if ( params.size() > 1 && !params[1].empty() )
+    {
+	m_max_size = ers::parse_size( params[1] );
+    }
+
+    if ( params.size() > 2 && !params[2].empty() )
+    {
+	std::istringstream in( params[2] );
+	in >> m_keep;
+    }
+
+    if ( params.size() > 3 && !params[3].empty() )
+    {
+	m_max_age = ers::parse_duration( params[3] );
+    }
+
+    m_fd = ::open( m_file_name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+    if ( m_fd < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, m_file_name.c_str() );
+    }
+    start_file();
+
+    scan();
+
+    m_thread = std::thread( &ers::RotatingFileStream::run, this );
+}
+
+ers::RotatingFileStream::~RotatingFileStream()
+{
+    {
+	std::unique_lock lock( m_compressor_mutex );
+	m_terminated = true;
+	m_compressor_condition.notify_one();
+    }
+    m_thread.join();
+    ::close( m_fd );
+}
+
+bool
+ers::RotatingFileStream::needsStack() const
+{
+    return Configuration::instance().verbosity_level() > 3;
+}
+
+std::string
+ers::RotatingFileStream::segment_name( unsigned long sequence ) const
+{
+    return m_file_name + '.' + std::to_string( sequence );
+}
+
+/** Initialises the size and the age limit of the file which has just been opened.
+  */
+void
+ers::RotatingFileStream::start_file( )
+{
+    struct stat st;
+    m_size = ::fstat( m_fd, &st ) ? 0 : st.st_size;
+    m_deadline = std::chrono::steady_clock::now() + m_max_age;
+}
+
+/** Looks for the segments left by previous instances of this stream. New segments will get
+  * greater sequence numbers and segments which have not been compressed are queued for compression.
+  */
+void
+ers::RotatingFileStream::scan( )
+{
+    std::map<unsigned long, std::vector<std::string>> segments = list_segments( m_file_name );
+    for ( auto & s : segments )
+    {
+	m_sequence = s.first;
+	if ( s.second.size() != 1 || s.second[0].size() < 3
+	     || s.second[0].compare( s.second[0].size() - 3, 3, ".gz" ) )
+	{
+	    m_pending.push_back( s.first );
+	}
+    }
+}
+
+/** Renames the current file to the next segment and opens a new one. This function is called
+  * with the file mutex locked, so it does nothing else.
+  * \return descriptor of the renamed file, which has to be closed by the caller, or -1 if rotation failed
+  */
+int
+ers::RotatingFileStream::rotate( )
+{
+    std::string segment = segment_name( m_sequence + 1 );
+    if ( ::rename( m_file_name.c_str(), segment.c_str() ) )
+    {
+	ERS_INTERNAL_ERROR( "Can not rename \"" << m_file_name << "\" file to \"" << segment << "\": "
+		<< strerror( errno ) )
+	m_deadline = std::chrono::steady_clock::now() + m_max_age;
+	return -1;
+    }
+    ++m_sequence;
+
+    int fd = ::open( m_file_name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+    if ( fd < 0 )
+    {
+	ERS_INTERNAL_ERROR( "Can not open \"" << m_file_name << "\" file: " << strerror( errno )
+		<< ", issues will be written to the \"" << segment << "\" file" )
+	m_deadline = std::chrono::steady_clock::now() + m_max_age;
+	return -1;
+    }
+
+    std::swap( fd, m_fd );
+    start_file();
+    return fd;
+}
+
+/** Write method
+  * prints the issue to the current file, rotating it before if it has reached the size or the age limit.
+  * \param issue issue to be sent.
+  */
+void
+ers::RotatingFileStream::write( const Issue & issue )
+{
+    thread_local std::string line;
+    thread_local StringStreamBuffer line_buffer( line );
+    thread_local std::ostream out( &line_buffer );
+
+    line.clear();
+    out.clear();
+    StandardStreamOutput::println( out, issue, Configuration::instance().verbosity_level() );
+
+    int old_fd = -1;
+    unsigned long segment = 0;
+    {
+	std::unique_lock lock( m_mutex );
+	if ( m_size
+	     && ( ( m_max_size && m_size + line.size() > m_max_size )
+		  || ( m_max_age.count() && std::chrono::steady_clock::now() >= m_deadline ) ) )
+	{
+	    old_fd = rotate();
+	    segment = m_sequence;
+	}
+
+	ers::write_all( m_fd, line.data(), line.size() );
+	m_size += line.size();
+    }
+
+    if ( old_fd >= 0 )
+    {
+	::close( old_fd );
+
+	std::unique_lock lock( m_compressor_mutex );
+	m_pending.push_back( segment );
+	m_compressor_condition.notify_one();
+    }
+
+    chained().write( issue );
+}
+
+/** Compresses the given segment to a gzip file and removes the original one.
+  */
+void
+ers::RotatingFileStream::compress( unsigned long sequence )
+{
+    std::string segment = segment_name( sequence );
+    std::string compressed = segment + ".gz";
+    std::string temporary = compressed + ".tmp";
+
+    int in = ::open( segment.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( in < 0 )
+    {
+	// the segment may have been already removed as an old one
+	return ;
+    }
+
+    gzFile out = ::gzopen( temporary.c_str(), "wb" );
+    if ( !out )
+    {
+	ERS_INTERNAL_ERROR( "Can not create \"" << temporary << "\" file" )
+	::close( in );
+	return ;
+    }
+
+    bool ok = true;
+    char buffer[65536];
+    ssize_t n;
+    while ( ( n = ::read( in, buffer, sizeof( buffer ) ) ) != 0 )
+    {
+	if ( n < 0 )
+	{
+	    if ( errno == EINTR )
+		continue;
+	    ok = false;
+	    break;
+	}
+	if ( ::gzwrite( out, buffer, n ) != n )
+	{
+	    ok = false;
+	    break;
+	}
+    }
+    ::close( in );
+
+    if ( ::gzclose( out ) != Z_OK || !ok )
+    {
+	ERS_INTERNAL_ERROR( "Can not compress \"" << segment << "\" file" )
+	::unlink( temporary.c_str() );
+	return ;
+    }
+
+    if ( ::rename( temporary.c_str(), compressed.c_str() ) )
+    {
+	ERS_INTERNAL_ERROR( "Can not rename \"" << temporary << "\" file to \"" << compressed << "\": "
+		<< strerror( errno ) )
+	::unlink( temporary.c_str() );
+	return ;
+    }
+    ::unlink( segment.c_str() );
+}
+
+/** Removes the oldest segments leaving no more than the configured number of them.
+  */
+void
+ers::RotatingFileStream::remove_old( )
+{
+    std::map<unsigned long, std::vector<std::string>> segments = list_segments( m_file_name );
+    for ( auto it = segments.begin(); segments.size() > m_keep; it = segments.erase( it ) )
+    {
+	for ( auto & name : it->second )
+	    ::unlink( name.c_str() );
+    }
+}
+
+/** Compresses closed segments. The segments which are still pending when the stream
+  * is destroyed are left as they are and will be compressed by the next instance of the stream.
+  */
+void
+ers::RotatingFileStream::run( )
+{
+    std::unique_lock lock( m_compressor_mutex );
+    while ( true )
+    {
+	m_compressor_condition.wait( lock, [this]{ return m_terminated || !m_pending.empty(); } );
+	if ( m_terminated )
+	    break;
+
+	unsigned long sequence = m_pending.front();
+	m_pending.pop_front();
+
+	lock.unlock();
+	compress( sequence );
+	remove_old();
+	lock.lock();
+    }
+}
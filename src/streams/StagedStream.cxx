@@ -0,0 +1,600 @@
+/*
+ *  StagedStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ers/SampleIssues.h>
+#include <ers/internal/StagedStream.h>
+#include <ers/internal/StandardStream.h>
+#include <ers/internal/Util.h>
+
+namespace
+{
+    template <int Fd>
+    struct StagedStandardStream : public ers::StagedStream
+    {
+	StagedStandardStream( const std::string & format )
+	  : StagedStream( Fd, format )
+	{ ; }
+    };
+
+    typedef StagedStandardStream<STDOUT_FILENO> StagedOutputStream;
+    typedef StagedStandardStream<STDERR_FILENO> StagedErrorStream;
+}
+
+ERS_REGISTER_OUTPUT_STREAM( StagedOutputStream, "sstdout", format )
+ERS_REGISTER_OUTPUT_STREAM( StagedErrorStream, "sstderr", format )
+ERS_REGISTER_OUTPUT_STREAM( ers::StagedStream, "sfile", format )
+
+ERS_DECLARE_ISSUE(	ers,
+			StagedIssuesDropped,
+			count << " issue(s) have been discarded because the staging buffer of the thread "
+			<< thread << " was full",
+			((size_t)count) ((pid_t)thread) )
+
+namespace
+{
+    const std::chrono::milliseconds DefaultLag( 50 );
+    const size_t DefaultBufferSize = 256*1024;
+
+    // Crash handlers give up waiting for the writer thread after this time
+    const std::chrono::milliseconds FlushTimeout( 500 );
+
+    /** Single producer single consumer ring of rendered lines. Every line is preceded by a header
+      * with its size and time and starts at an 8 bytes aligned offset. Lines never wrap around the
+      * end of the buffer, a Wrap size tells the reader to continue from the beginning. Only the size
+      * is written in this case, since there may be just 8 bytes left before the end of the buffer.
+      */
+    class StagingBuffer
+    {
+      public:
+	struct Header
+	{
+	    uint32_t	size;
+	    int64_t	time;
+	};
+
+	static const uint32_t Wrap = ~uint32_t( 0 );
+
+	explicit StagingBuffer( size_t capacity )
+	  : m_capacity( std::max<size_t>( ( capacity + 7 ) & ~size_t( 7 ), 4096 ) ),
+	    m_data( new char[m_capacity] ),
+	    m_head( 0 ),
+	    m_tail( 0 ),
+	    m_dropped( 0 ),
+	    m_closed( false ),
+	    m_thread_id( gettid() )
+	{ ; }
+
+	static uint64_t record_size( size_t size )
+	{ return ( sizeof( Header ) + size + 7 ) & ~uint64_t( 7 ); }
+
+	/** Called by the owning thread only.
+	  * \return false if there is no space for the line
+	  */
+	bool push( int64_t time, const std::string & line )
+	{
+	    uint64_t size = record_size( line.size() );
+	    uint64_t head = m_head.load( std::memory_order_relaxed );
+	    uint64_t position = head % m_capacity;
+	    uint64_t contiguous = m_capacity - position;
+	    uint64_t needed = size <= contiguous ? size : size + contiguous;
+	    if ( m_capacity - ( head - m_tail.load( std::memory_order_acquire ) ) < needed )
+	    {
+		return false;
+	    }
+
+	    if ( size > contiguous )
+	    {
+		uint32_t wrap = Wrap;
+		memcpy( m_data.get() + position, &wrap, sizeof( wrap ) );
+		head += contiguous;
+		position = 0;
+	    }
+
+	    Header header = { uint32_t( line.size() ), time };
+	    memcpy( m_data.get() + position, &header, sizeof( header ) );
+	    memcpy( m_data.get() + position + sizeof( header ), line.data(), line.size() );
+	    m_head.store( head + size, std::memory_order_release );
+	    return true;
+	}
+
+	/** Called by the writer thread only. Passes all the available lines to the given function. */
+	template <class F>
+	void pop( F f )
+	{
+	    uint64_t tail = m_tail.load( std::memory_order_relaxed );
+	    uint64_t head = m_head.load( std::memory_order_acquire );
+	    while ( tail != head )
+	    {
+		uint64_t position = tail % m_capacity;
+		uint32_t size;
+		memcpy( &size, m_data.get() + position, sizeof( size ) );
+		if ( size == Wrap )
+		{
+		    tail += m_capacity - position;
+		    continue;
+		}
+		Header header;
+		memcpy( &header, m_data.get() + position, sizeof( header ) );
+		f( header.time, m_data.get() + position + sizeof( header ), header.size );
+		tail += record_size( header.size );
+	    }
+	    m_tail.store( tail, std::memory_order_release );
+	}
+
+	bool half_full() const
+	{
+	    return ( m_head.load( std::memory_order_relaxed ) - m_tail.load( std::memory_order_relaxed ) ) * 2 > m_capacity;
+	}
+
+	const uint64_t			m_capacity;
+	std::unique_ptr<char[]>		m_data;
+	std::atomic<uint64_t>		m_head;
+	std::atomic<uint64_t>		m_tail;
+	std::atomic<size_t>		m_dropped;	/**< \brief number of lines discarded because the buffer was full */
+	std::atomic<bool>		m_closed;	/**< \brief the owning thread has exited */
+	const pid_t			m_thread_id;
+    };
+
+    static_assert( offsetof( StagingBuffer::Header, size ) == 0, "the wrap marker must overlay the size of a line" );
+}
+
+namespace ers
+{
+    /** Merges the lines from the staging buffers of all threads and writes them to a single output.
+      * The writers are never destroyed, since the threads keep pointers to their staging buffers,
+      * but their threads are stopped and joined when the process exits normally.
+      */
+    class StagedWriter
+    {
+      public:
+	static StagedWriter & get( int fd, const std::string & format );
+
+	void write( const Issue & issue );
+
+	void flush( );
+
+	void stop( );
+
+      private:
+	struct Line
+	{
+	    int64_t	time;
+	    size_t	offset;
+	    size_t	size;
+	};
+
+	/** Marks the staging buffers of a thread as closed when the thread exits,
+	  * the buffers are deleted by the writers after the remaining lines are written. */
+	struct Owner
+	{
+	    ~Owner()
+	    {
+		for ( auto & b : buffers )
+		    b.second->m_closed.store( true, std::memory_order_release );
+	    }
+
+	    std::vector<std::pair<StagedWriter *, StagingBuffer *>>	buffers;
+	};
+
+	StagedWriter( int fd, const std::chrono::milliseconds & lag, size_t buffer_size );
+
+	StagingBuffer & buffer( );
+
+	void wakeup( );
+
+	void collect( );
+
+	void write_lines( bool all );
+
+	void run( );
+
+	static void stop_all( );
+
+	int						m_fd;
+	std::chrono::milliseconds			m_lag;
+	size_t						m_buffer_size;
+	std::mutex					m_mutex;		/**< \brief protects the buffers, the counters and the flags */
+	std::condition_variable				m_condition;
+	std::vector<std::unique_ptr<StagingBuffer>>	m_buffers;
+	std::atomic<bool>				m_wakeup;		/**< \brief a staging buffer is getting full */
+	uint64_t					m_requested;		/**< \brief number of flush requests */
+	uint64_t					m_processed;		/**< \brief number of flush requests which have been served */
+	bool						m_stopping;		/**< \brief the thread must write all the lines and exit */
+	bool						m_stopped;		/**< \brief the thread has been joined */
+	std::mutex					m_output_mutex;		/**< \brief serialises flushes after the thread has been stopped */
+	std::thread					m_thread;
+	std::thread::id					m_thread_id;
+	std::string					m_text;			/**< \brief lines which have not been written yet */
+	std::vector<Line>				m_lines;
+	std::string					m_output;
+    };
+}
+
+/** Returns the writer for the given output, creating it if necessary.
+  * \param fd file descriptor of the output or -1 if the first parameter of the format is the file name
+  * \param format comma separated parameters of the stream
+  */
+namespace
+{
+    std::mutex * writers_mutex = new std::mutex;
+    std::map<std::string, ers::StagedWriter *> * writers = new std::map<std::string, ers::StagedWriter *>;
+}
+
+ers::StagedWriter &
+ers::StagedWriter::get( int fd, const std::string & format )
+{
+
+    std::vector<std::string> params;
+    ers::tokenize( format, ",", params );
+
+    std::string output;
+    if ( fd < 0 )
+    {
+	if ( params.empty() || params[0].empty() )
+	{
+	    throw ers::CantOpenFile( ERS_HERE, "" );
+	}
+	output = params[0];
+	params.erase( params.begin() );
+    }
+    else
+    {
+	output = "/dev/fd/" + std::to_string( fd );
+    }
+
+    std::unique_lock lock( *writers_mutex );
+    StagedWriter *& writer = (*writers)[output];
+    if ( !writer )
+    {
+	std::chrono::milliseconds lag = DefaultLag;
+	if ( params.size() > 0 && !params[0].empty() )
+	{
+	    std::istringstream in( params[0] );
+	    long ms = 0;
+	    in >> ms;
+	    lag = std::chrono::milliseconds( std::max( ms, 1L ) );
+	}
+
+	size_t buffer_size = DefaultBufferSize;
+	if ( params.size() > 1 && !params[1].empty() )
+	{
+	    buffer_size = ers::parse_size( params[1] );
+	}
+
+	if ( fd < 0 )
+	{
+	    fd = ::open( output.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+	    if ( fd < 0 )
+	    {
+		writers->erase( output );
+		throw ers::CantOpenFile( ERS_HERE, output.c_str() );
+	    }
+	}
+	static bool registered = false;
+	if ( !registered )
+	{
+	    // the handler is registered after the one of the StreamManager, so it is called before it
+	    ::atexit( stop_all );
+	    registered = true;
+	}
+	writer = new StagedWriter( fd, lag, buffer_size );
+    }
+    return *writer;
+}
+
+/** Stops the threads of all the writers at exit, so they do not run while the static objects are destroyed. */
+void
+ers::StagedWriter::stop_all( )
+{
+    // the threads of a crashing application may never finish, the crash handlers flush the streams instead
+    if ( Context::is_crashing() )
+	return ;
+
+    std::unique_lock lock( *writers_mutex );
+    for ( auto & w : *writers )
+    {
+	if ( w.second )
+	    w.second->stop();
+    }
+}
+
+ers::StagedWriter::StagedWriter( int fd, const std::chrono::milliseconds & lag, size_t buffer_size )
+  : m_fd( fd ),
+    m_lag( lag ),
+    m_buffer_size( buffer_size ),
+    m_wakeup( false ),
+    m_requested( 0 ),
+    m_processed( 0 ),
+    m_stopping( false ),
+    m_stopped( false )
+{
+    m_thread = std::thread( &ers::StagedWriter::run, this );
+    m_thread_id = m_thread.get_id();
+}
+
+/** Writes all the lines which are in the staging buffers and joins the writer thread. */
+void
+ers::StagedWriter::stop( )
+{
+    {
+	std::unique_lock lock( m_mutex );
+	m_stopping = true;
+	m_condition.notify_all();
+    }
+    m_thread.join();
+
+    std::unique_lock lock( m_mutex );
+    m_stopped = true;
+    m_condition.notify_all();
+}
+
+/** \return staging buffer of the current thread for this writer */
+StagingBuffer &
+ers::StagedWriter::buffer( )
+{
+    thread_local Owner owner;
+    thread_local StagedWriter * last_writer = 0;
+    thread_local StagingBuffer * last_buffer = 0;
+
+    if ( last_writer == this )
+	return *last_buffer;
+
+    auto it = std::find_if( owner.buffers.begin(), owner.buffers.end(),
+	    [this]( const std::pair<StagedWriter *, StagingBuffer *> & b ) { return b.first == this; } );
+    if ( it == owner.buffers.end() )
+    {
+	StagingBuffer * b = new StagingBuffer( m_buffer_size );
+	{
+	    std::unique_lock lock( m_mutex );
+	    m_buffers.emplace_back( b );
+	}
+	it = owner.buffers.emplace( owner.buffers.end(), this, b );
+    }
+
+    last_writer = this;
+    last_buffer = it->second;
+    return *last_buffer;
+}
+
+void
+ers::StagedWriter::write( const Issue & issue )
+{
+    thread_local std::string line;
+    thread_local StringStreamBuffer line_buffer( line );
+    thread_local std::ostream out( &line_buffer );
+
+    line.clear();
+    out.clear();
+    StandardStreamOutput::println( out, issue, Configuration::instance().verbosity_level() );
+
+    int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+	    issue.ptime().time_since_epoch() ).count();
+
+    StagingBuffer & b = buffer();
+    if ( b.push( time, line ) )
+    {
+	if ( b.half_full() )
+	    wakeup();
+	return ;
+    }
+
+    // the reporting thread never waits for the writer, which is woken up to make space for the next lines
+    b.m_dropped.fetch_add( 1, std::memory_order_relaxed );
+    wakeup();
+}
+
+void
+ers::StagedWriter::wakeup( )
+{
+    m_wakeup.store( true, std::memory_order_relaxed );
+    m_condition.notify_one();
+}
+
+/** Waits until all the lines which are in the staging buffers are written to the output.
+  * This function is called by the crash handlers, so it does not wait forever for the writer thread.
+  * Once the thread has been stopped at exit, the lines are written by the calling thread.
+  */
+void
+ers::StagedWriter::flush( )
+{
+    if ( std::this_thread::get_id() == m_thread_id )
+    {
+	collect();
+	write_lines( true );
+	return ;
+    }
+
+    std::unique_lock lock( m_mutex );
+    if ( !m_stopped )
+    {
+	uint64_t request = ++m_requested;
+	m_condition.notify_all();
+	m_condition.wait_for( lock, FlushTimeout, [this, request]{ return m_processed >= request || m_stopped; } );
+	if ( !m_stopped )
+	    return ;
+    }
+    lock.unlock();
+
+    std::unique_lock output_lock( m_output_mutex );
+    collect();
+    write_lines( true );
+}
+
+/** Moves the lines from the staging buffers to the list of pending lines and deletes
+  * the buffers of the threads which have exited.
+  */
+void
+ers::StagedWriter::collect( )
+{
+    std::vector<StagingBuffer *> buffers;
+    {
+	std::unique_lock lock( m_mutex );
+	for ( auto & b : m_buffers )
+	    buffers.push_back( b.get() );
+    }
+
+    std::vector<StagingBuffer *> closed;
+    for ( StagingBuffer * b : buffers )
+    {
+	// the lines written before the thread has exited are taken by the call below
+	bool is_closed = b->m_closed.load( std::memory_order_acquire );
+	b->pop( [this]( int64_t time, const char * text, size_t size ) {
+	    m_lines.push_back( Line{ time, m_text.size(), size } );
+	    m_text.append( text, size );
+	} );
+
+	if ( size_t dropped = b->m_dropped.exchange( 0, std::memory_order_relaxed ) )
+	{
+	    std::ostringstream out;
+	    ers::StagedIssuesDropped notice( ERS_HERE, dropped, b->m_thread_id );
+	    notice.set_severity( ers::Warning );
+	    StandardStreamOutput::println( out, notice, Configuration::instance().verbosity_level() );
+	    m_lines.push_back( Line{ std::chrono::duration_cast<std::chrono::nanoseconds>(
+		    notice.ptime().time_since_epoch() ).count(), m_text.size(), out.str().size() } );
+	    m_text.append( out.str() );
+	}
+
+	if ( is_closed )
+	    closed.push_back( b );
+    }
+
+    if ( !closed.empty() )
+    {
+	std::unique_lock lock( m_mutex );
+	for ( StagingBuffer * b : closed )
+	{
+	    m_buffers.erase( std::find_if( m_buffers.begin(), m_buffers.end(),
+		    [b]( const std::unique_ptr<StagingBuffer> & p ) { return p.get() == b; } ) );
+	}
+    }
+}
+
+/** Writes the pending lines in the time order with a single system call.
+  * \param all if false only the lines which are older than the lag window are written
+  */
+void
+ers::StagedWriter::write_lines( bool all )
+{
+    if ( m_lines.empty() )
+	return ;
+
+    // the sort is stable, so the lines of a thread which have the same time keep their order
+    std::stable_sort( m_lines.begin(), m_lines.end(),
+	    []( const Line & a, const Line & b ) { return a.time < b.time; } );
+
+    std::vector<Line>::iterator end = m_lines.end();
+    if ( !all )
+    {
+	int64_t limit = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		( system_clock::now() - m_lag ).time_since_epoch() ).count();
+	end = std::upper_bound( m_lines.begin(), m_lines.end(), limit,
+		[]( int64_t time, const Line & l ) { return time < l.time; } );
+    }
+
+    m_output.clear();
+    for ( auto it = m_lines.begin(); it != end; ++it )
+	m_output.append( m_text, it->offset, it->size );
+    ers::write_all( m_fd, m_output.data(), m_output.size() );
+
+    m_lines.erase( m_lines.begin(), end );
+    if ( m_lines.empty() )
+    {
+	m_text.clear();
+    }
+    else if ( m_text.size() > 2*m_buffer_size )
+    {
+	// compact the text of the lines which are kept
+	m_output.clear();
+	for ( Line & l : m_lines )
+	{
+	    m_output.append( m_text, l.offset, l.size );
+	    l.offset = m_output.size() - l.size;
+	}
+	m_text.swap( m_output );
+    }
+}
+
+void
+ers::StagedWriter::run( )
+{
+    while ( true )
+    {
+	std::unique_lock lock( m_mutex );
+	// for lags shorter than 2ms the half of the lag would be zero, which makes the thread spin
+	m_condition.wait_for( lock, std::max( m_lag / 2, std::chrono::milliseconds( 1 ) ), [this]{
+		return m_requested != m_processed || m_stopping || m_wakeup.load( std::memory_order_relaxed ); } );
+	uint64_t request = m_requested;
+	bool stopping = m_stopping;
+	m_wakeup.store( false, std::memory_order_relaxed );
+	lock.unlock();
+
+	collect();
+	write_lines( stopping || request != m_processed );
+
+	lock.lock();
+	m_processed = request;
+	m_condition.notify_all();
+	if ( stopping )
+	    return ;
+    }
+}
+
+/** Constructor that creates a new instance of the staged stream which writes to a file.
+  * \param format comma separated file name, lag window and staging buffer size
+  */
+ers::StagedStream::StagedStream( const std::string & format )
+  : m_writer( StagedWriter::get( -1, format ) )
+{ ; }
+
+/** Constructor that creates a new instance of the staged stream which writes to the given file descriptor.
+  * \param fd output file descriptor
+  * \param format comma separated lag window and staging buffer size
+  */
+ers::StagedStream::StagedStream( int fd, const std::string & format )
+  : m_writer( StagedWriter::get( fd, format ) )
+{ ; }
+
+bool
+ers::StagedStream::needsStack() const
+{
+    return Configuration::instance().verbosity_level() > 3;
+}
+
+/** Write method
+  * renders the issue into the staging buffer of the current thread.
+  * \param issue issue to be sent.
+  */
+void
+ers::StagedStream::write( const Issue & issue )
+{
+    m_writer.write( issue );
+    chained().write( issue );
+}
+
+/** Writes the lines which are still in the staging buffers. */
+void
+ers::StagedStream::flush( )
+{
+    m_writer.flush();
+    chained().flush();
+}
@@ -7,6 +7,9 @@
  *
  */
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <iostream>
 #include <fstream>
 #include <mutex>
@@ -15,9 +18,14 @@
 
 #include <ers/internal/StandardStream.h>
 #include <ers/internal/FormattedStandardStream.h>
+#include <ers/internal/Util.h>
 
 namespace
 {
+    /** Every device provides the device() function, which returns an object used for writing
+      * a single issue and holds the device lock if there is one, and the flush() function,
+      * which is called by the streams directly and must never wait for the device lock.
+      */
     struct OutDevice
     {
 	explicit OutDevice( std::ostream & out )
@@ -27,6 +35,12 @@ namespace
         std::ostream & stream() const
         { return out_; }
         
+        void write( const char * data, size_t size ) const
+        { out_.write( data, size ); }
+        
+        void flush( ) const
+        { out_.flush(); }
+        
         const OutDevice & device()
         { return *this; }
       
@@ -102,6 +116,15 @@ namespace
         {
 	    return LockedDevice( stream(), mutex() );
         }
+        
+        // Is called at exit or from a crash handler, so must not wait for a thread
+        // which may never release the lock, e.g. the crashing one
+        void flush( )
+        {
+            std::unique_lock<std::mutex> lock( mutex(), std::try_to_lock );
+            if ( lock )
+        	stream().flush();
+        }
     };
         
     
@@ -137,6 +160,64 @@ namespace
       private:
       	std::ofstream out_;
     };
+    
+    /** Device which writes directly to a file descriptor, bypassing the C++ streams.
+      * Every issue is passed to a single write system call, so lines written by different
+      * threads or, for files opened in append mode, by different processes do not interleave.
+      */
+    struct FdDevice
+    {
+	explicit FdDevice( int fd )
+          : fd_( fd )
+	{ ; }
+        
+        void write( const char * data, size_t size ) const
+        { ers::write_all( fd_, data, size ); }
+        
+        void flush( ) const
+        { ; }
+        
+        const FdDevice & device()
+        { return *this; }
+      
+      private:
+        FdDevice(const FdDevice &) = delete;
+        FdDevice & operator=(const FdDevice &) = delete;
+
+      protected:
+      	int fd_;
+    };
+    
+    struct FdOutputDevice : public FdDevice
+    {
+	FdOutputDevice( const std::string & = "" ) 
+	  : FdDevice( STDOUT_FILENO )
+	{ ; }
+    };
+    
+    struct FdErrorDevice : public FdDevice
+    {
+	FdErrorDevice( const std::string & = "" ) 
+	  : FdDevice( STDERR_FILENO )
+	{ ; }
+    };
+    
+    struct FdFileDevice : public FdDevice
+    {
+	FdFileDevice( const std::string & file_name )
+          : FdDevice( ::open( file_name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 ) )
+	{
+            if ( fd_ < 0 )
+            {
+            	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+            }
+        }
+        
+        ~FdFileDevice()
+        {
+            ::close( fd_ );
+        }
+    };
 }
 
 ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<FileDevice<OutDevice> >, "file", file_name )
@@ -154,3 +235,11 @@ ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<ErrorDevice<OutDevice>
 ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<FileDevice<LockableDevice<> > >, "lffile", format )
 ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<OutputDevice<LockableDevice<ClassLock<1> > > >, "lfstdout", format )
 ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<ErrorDevice<LockableDevice<ClassLock<2> > > >, "lfstderr", format )
+
+ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<FdFileDevice>, "fdfile", file_name )
+ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<FdOutputDevice>, "fdstdout", ERS_EMPTY)
+ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<FdErrorDevice>, "fdstderr", ERS_EMPTY)
+
+ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<FdFileDevice>, "ffdfile", format )
+ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<FdOutputDevice>, "ffdstdout", format )
+ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<FdErrorDevice>, "ffdstderr", format )
@@ -6,8 +6,15 @@
  *  Copyright 2004 CERN. All rights reserved.
  *
  */
-#include <boost/lexical_cast.hpp>
+#include <stdio.h>
 
+#include <algorithm>
+#include <ctime>
+#include <string_view>
+
+#include <boost/algorithm/string.hpp>
+
+#include <ers/CallSite.h>
 #include <ers/internal/FilterStream.h>
 #include <ers/internal/Util.h>
 #include <ers/StreamFactory.h>
@@ -16,6 +23,87 @@
 
 ERS_REGISTER_OUTPUT_STREAM( ers::ThrottleStream, "throttle", format )
 
+namespace
+{
+    const size_t InitialShardSize = 64;
+    const size_t DefaultMaxRecords = 10000;
+    const int DefaultIdleTimeout = 600;
+    const double DefaultRate = 10;
+    const int DefaultBurst = 30;
+
+    /** Returns a non-zero hash of the issue call site. The issues created with ERS_HERE are identified
+      * by their call site descriptor, for the others the file name is hashed by content since the contexts
+      * of the issues received from other applications keep their own copies.
+      */
+    uint64_t callSiteHash(const ers::Context& context)
+    {
+	uint64_t h;
+	if (const ers::CallSite* site = context.call_site()) {
+	    h = site->id();
+	}
+	else {
+	    h = std::hash<std::string_view>()(context.file_name());
+	    h ^= uint64_t(context.line_number()) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+	}
+	// mix the bits, since the top ones select the shard and the bottom ones the slot
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h ? h : 1;
+    }
+
+    inline int64_t nanoseconds(const system_clock::time_point& time)
+    {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    /** Parses the rate given as "N/unit" where unit is one of ms, s, m or h.
+      * \return number of nanoseconds per issue or 0 if the rate is not valid
+      */
+    int64_t parseRate(const std::string& text)
+    {
+	std::istringstream in(text);
+	double rate = 0;
+	in >> rate;
+
+	std::string unit;
+	if (in.get() == '/') {
+	    in >> unit;
+	}
+
+	double period = 1e9;
+	if (unit == "ms")
+	    period = 1e6;
+	else if (unit == "m" || unit == "min")
+	    period = 60e9;
+	else if (unit == "h")
+	    period = 3600e9;
+	else if (!unit.empty() && unit != "s")
+	    rate = 0;
+
+	if (!(rate > 0)) {
+	    ERS_INTERNAL_ERROR( "Invalid rate \"" << text << "\" is given for the throttle stream" )
+	    return 0;
+	}
+	return std::max<int64_t>(period / rate, 1);
+    }
+
+    /** Formats the time in the same way as the standard streams do. */
+    std::string formatTime(const system_clock::time_point& time)
+    {
+	long long us = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+	std::time_t t = us / 1000000;
+	std::tm tm;
+	localtime_r(&t, &tm);
+	char buffer[64];
+	size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%b-%d %H:%M:%S", &tm);
+	snprintf(buffer + n, sizeof(buffer) - n, ",%06lld", us % 1000000);
+	return buffer;
+    }
+}
+
 ers::ThrottleStream::IssueRecord::IssueRecord()
 {
     reset();
@@ -24,19 +112,162 @@ ers::ThrottleStream::IssueRecord::IssueRecord()
 void 
 ers::ThrottleStream::IssueRecord::reset()
 {
-    m_lastOccurance=0;
-    m_lastReport=0;
+    m_lastOccurance=system_clock::time_point();
+    m_lastReport=system_clock::time_point();
+    m_allowedAt=0;
+    m_suppressedIssue.reset();
     m_initialCounter=0;
     m_threshold=10;
     m_suppressedCounter=0;
 }
 
+ers::ThrottleStream::Shard::Shard()
+  : m_slots(InitialShardSize),
+    m_size(0)
+{ ; }
+
+/** Returns the record for the given key, a new record is added if there is none.
+  * If the shard is full the least recently used records are evicted.
+  * Must be called with the shard mutex locked.
+  */
+ers::ThrottleStream::IssueRecord&
+ers::ThrottleStream::findRecord(Shard& shard, uint64_t key, const system_clock::time_point& now)
+{
+    size_t mask = shard.m_slots.size() - 1;
+    for (size_t i = key & mask; ; i = (i + 1) & mask) {
+	Shard::Slot& slot = shard.m_slots[i];
+	if (slot.m_key == key) {
+	    return slot.m_record;
+	}
+	if (!slot.m_key) {
+	    if (shard.m_size >= m_shardCapacity) {
+		expire(shard, now);
+		if (shard.m_size >= m_shardCapacity) {
+		    evictOldest(shard);
+		}
+		return findRecord(shard, key, now);
+	    }
+	    // keep the load factor below 1/2
+	    if (2*(shard.m_size + 1) > shard.m_slots.size()) {
+		grow(shard);
+		return findRecord(shard, key, now);
+	    }
+	    slot.m_key = key;
+	    ++shard.m_size;
+	    return slot.m_record;
+	}
+    }
+}
+
+void
+ers::ThrottleStream::grow(Shard& shard)
+{
+    std::vector<Shard::Slot> slots(2*shard.m_slots.size());
+    slots.swap(shard.m_slots);
+
+    size_t mask = shard.m_slots.size() - 1;
+    for (Shard::Slot& slot : slots) {
+	if (slot.m_key) {
+	    size_t i = slot.m_key & mask;
+	    while (shard.m_slots[i].m_key) {
+		i = (i + 1) & mask;
+	    }
+	    shard.m_slots[i].m_key = slot.m_key;
+	    shard.m_slots[i].m_record = std::move(slot.m_record);
+	}
+    }
+}
+
+/** Removes the record from the given slot, reporting the issues it has suppressed.
+  * The following records of the same probe sequence are shifted backwards to fill the gap,
+  * so no tombstones are needed.
+  */
+void
+ers::ThrottleStream::evict(Shard& shard, size_t index)
+{
+    IssueRecord& record = shard.m_slots[index].m_record;
+    if (record.m_suppressedCounter > 0 && record.m_suppressedIssue) {
+	std::unique_ptr<ers::Issue> issue = std::move(record.m_suppressedIssue);
+	reportSuppression(record, *issue);
+    }
+
+    size_t mask = shard.m_slots.size() - 1;
+    for (size_t j = (index + 1) & mask; shard.m_slots[j].m_key; j = (j + 1) & mask) {
+	size_t home = shard.m_slots[j].m_key & mask;
+	// the record at j can be moved to the gap if its home slot is not within (index, j]
+	if (((j - home) & mask) >= ((j - index) & mask)) {
+	    shard.m_slots[index].m_key = shard.m_slots[j].m_key;
+	    shard.m_slots[index].m_record = std::move(shard.m_slots[j].m_record);
+	    index = j;
+	}
+    }
+    shard.m_slots[index].m_key = 0;
+    shard.m_slots[index].m_record.reset();
+    --shard.m_size;
+}
+
+/** Removes the records of the issues which have not been reported for longer than the idle timeout. */
+void
+ers::ThrottleStream::expire(Shard& shard, const system_clock::time_point& now)
+{
+    size_t expired = 0;
+    for (size_t i = 0; i < shard.m_slots.size(); ) {
+	if (shard.m_slots[i].m_key && now - shard.m_slots[i].m_record.m_lastOccurance > m_idleTimeout) {
+	    // the slot gets another record, which has to be checked as well
+	    evict(shard, i);
+	    ++expired;
+	}
+	else {
+	    ++i;
+	}
+    }
+
+    if (expired) {
+	m_expired += expired;
+	ERS_INTERNAL_DEBUG(1, expired << " idle throttling record(s) have been discarded, "
+		<< m_expired << " expired and " << m_evicted << " evicted so far")
+    }
+}
+
+/** Removes the least recently used records, which are about 1/8 of the shard capacity. */
+void
+ers::ThrottleStream::evictOldest(Shard& shard)
+{
+    std::vector<std::pair<system_clock::time_point, uint64_t>> records;
+    records.reserve(shard.m_size);
+    for (const Shard::Slot& slot : shard.m_slots) {
+	if (slot.m_key) {
+	    records.emplace_back(slot.m_record.m_lastOccurance, slot.m_key);
+	}
+    }
+
+    size_t count = std::min(std::max<size_t>(m_shardCapacity/8, 1), records.size());
+    std::nth_element(records.begin(), records.begin() + count - 1, records.end());
+
+    size_t mask = shard.m_slots.size() - 1;
+    for (size_t n = 0; n < count; ++n) {
+	uint64_t key = records[n].second;
+	size_t i = key & mask;
+	while (shard.m_slots[i].m_key != key) {
+	    i = (i + 1) & mask;
+	}
+	evict(shard, i);
+    }
+
+    if (!m_evicted.fetch_add(count)) {
+	ERS_INTERNAL_INFO("The throttle stream has reached the limit of " << m_shardCapacity*ShardsNumber
+		<< " issue types, the state of the least recently reported ones is discarded")
+    }
+    ERS_INTERNAL_DEBUG(1, count << " least recently used throttling record(s) have been discarded, "
+	    << m_expired << " expired and " << m_evicted << " evicted so far")
+}
+
 void 
 ers::ThrottleStream::reportSuppression(IssueRecord& record, const ers::Issue& issue)
 {
     std::ostringstream msgStream;
     msgStream << " -- " << record.m_suppressedCounter << " similar messages suppressed, last occurrence was at "
-		<< record.m_lastOccuranceFormatted;
+		<< formatTime(record.m_lastOccurance);
     
     ers::Issue* suppressedNotice = issue.clone();
     suppressedNotice->wrap_message( "",  msgStream.str());
@@ -45,14 +276,15 @@ ers::ThrottleStream::reportSuppression(IssueRecord& record, const ers::Issue& is
     chained().write(*suppressedNotice);
     delete suppressedNotice;
 
-    record.m_lastReport = issue.time_t();
+    record.m_lastReport = issue.ptime();
     record.m_suppressedCounter = 0;
+    record.m_suppressedIssue.reset();
 }
 
 void 
 ers::ThrottleStream::throttle(IssueRecord& rec, const ers::Issue& issue)
 {
-    std::time_t issueTime=issue.time_t();
+    const system_clock::time_point& issueTime=issue.ptime();
     bool reported=false;
     if (issueTime - rec.m_lastOccurance > m_timeLimit) {
 	if (rec.m_suppressedCounter>0) {
@@ -77,21 +309,121 @@ ers::ThrottleStream::throttle(IssueRecord& rec, const ers::Issue& issue)
 	reportSuppression(rec, issue);
     }
     else {
-	rec.m_suppressedCounter++;
+	if (!rec.m_suppressedCounter++) {
+	    rec.m_suppressedIssue.reset(issue.clone());
+	}
     }
 
     rec.m_lastOccurance=issueTime;
-    rec.m_lastOccuranceFormatted=issue.time<std::chrono::microseconds>();
+}
+
+/** Checks the issue against the per-type and global token buckets, which are implemented
+  * as the generic cell rate algorithm: an issue passes if it does not come earlier than
+  * the theoretical arrival time reduced by the burst tolerance.
+  */
+void
+ers::ThrottleStream::limitRate(IssueRecord& rec, const ers::Issue& issue)
+{
+    int64_t now = nanoseconds(issue.ptime());
+
+    if (rec.m_allowedAt - m_tolerance > now || !acquireGlobal(now)) {
+	if (!rec.m_suppressedCounter++) {
+	    rec.m_suppressedIssue.reset(issue.clone());
+	}
+    }
+    else {
+	rec.m_allowedAt = std::max(rec.m_allowedAt, now) + m_interval;
+	if (rec.m_suppressedCounter) {
+	    reportSuppression(rec, issue);
+	}
+	else {
+	    chained().write(issue);
+	}
+    }
+
+    rec.m_lastOccurance = issue.ptime();
+}
+
+bool
+ers::ThrottleStream::acquireGlobal(int64_t now)
+{
+    if (!m_globalInterval) {
+	return true;
+    }
+
+    int64_t allowedAt = m_globalAllowedAt.load(std::memory_order_relaxed);
+    do {
+	if (allowedAt - m_globalTolerance > now) {
+	    return false;
+	}
+    } while (!m_globalAllowedAt.compare_exchange_weak(allowedAt,
+		std::max(allowedAt, now) + m_globalInterval, std::memory_order_relaxed));
+    return true;
 }
 
 ers::ThrottleStream::ThrottleStream( const std::string & criteria )
+  : m_tokenBucket(false),
+    m_interval(0),
+    m_tolerance(0),
+    m_globalInterval(0),
+    m_globalTolerance(0),
+    m_globalAllowedAt(0),
+    m_expired(0),
+    m_evicted(0),
+    m_lastExpiration(system_clock::now())
 {
     m_initialThreshold = 30;
-    m_timeLimit = 30;
+    int timeLimit = 30;
+    size_t maxRecords = DefaultMaxRecords;
+    int idleTimeout = DefaultIdleTimeout;
     
     std::vector<std::string> params;
     ers::tokenize( criteria, ",", params );
     
+    if ( !params.empty() && params[0].find('=') != std::string::npos )
+    {
+	m_tokenBucket = true;
+	m_interval = int64_t(1e9 / DefaultRate);
+	int burst = DefaultBurst;
+	int globalBurst = 0;
+
+	for ( const std::string & p : params )
+	{
+	    std::string::size_type eq = p.find('=');
+	    std::string name = boost::algorithm::trim_copy( p.substr( 0, eq ) );
+	    std::string value = eq == std::string::npos ? "" : boost::algorithm::trim_copy( p.substr( eq + 1 ) );
+	    std::istringstream in( value );
+
+	    if ( name == "rate" ) {
+		if ( int64_t interval = parseRate( value ) )
+		    m_interval = interval;
+	    }
+	    else if ( name == "burst" )
+		in >> burst;
+	    else if ( name == "global" )
+		m_globalInterval = parseRate( value );
+	    else if ( name == "global_burst" )
+		in >> globalBurst;
+	    else if ( name == "max" )
+		in >> maxRecords;
+	    else if ( name == "idle" )
+		in >> idleTimeout;
+	    else
+		ERS_INTERNAL_ERROR( "Unknown parameter \"" << name << "\" is given for the throttle stream" )
+	}
+
+	if ( m_globalInterval && globalBurst <= 0 )
+	{
+	    globalBurst = std::max<int64_t>( 1000000000 / m_globalInterval, 1 );
+	}
+
+	m_tolerance = m_interval * ( std::max( burst, 1 ) - 1 );
+	m_globalTolerance = m_globalInterval * ( std::max( globalBurst, 1 ) - 1 );
+	m_shardCapacity = std::max<size_t>((maxRecords + ShardsNumber - 1) / ShardsNumber, 1);
+	m_idleTimeout = std::chrono::seconds(std::max(idleTimeout, 1));
+	return;
+    }
+
     if ( params.size() > 0 )
     {
 	std::istringstream in( params[0] );
@@ -101,8 +433,24 @@ ers::ThrottleStream::ThrottleStream( const std::string & criteria )
     if ( params.size() > 1 )
     {
 	std::istringstream in( params[1] );
-        in >> m_timeLimit;
+        in >> timeLimit;
     }
+
+    if ( params.size() > 2 )
+    {
+	std::istringstream in( params[2] );
+        in >> maxRecords;
+    }
+
+    if ( params.size() > 3 )
+    {
+	std::istringstream in( params[3] );
+        in >> idleTimeout;
+    }
+
+    m_timeLimit = std::chrono::seconds(timeLimit);
+    m_shardCapacity = std::max<size_t>((maxRecords + ShardsNumber - 1) / ShardsNumber, 1);
+    m_idleTimeout = std::chrono::seconds(std::max(idleTimeout, timeLimit));
 }
 
 /** Write method 
@@ -114,9 +462,24 @@ ers::ThrottleStream::ThrottleStream( const std::string & criteria )
 void 
 ers::ThrottleStream::write( const ers::Issue & issue )
 {
-    const ers::Context& context = issue.context();
-    std::string issueId = context.file_name() + boost::lexical_cast<std::string>(context.line_number());
+    // one of the threads discards idle records from all the shards, which reports their suppressed issues
+    system_clock::time_point last = m_lastExpiration.load(std::memory_order_relaxed);
+    if (issue.ptime() - last > m_idleTimeout && m_lastExpiration.compare_exchange_strong(last, issue.ptime())) {
+	for (Shard& shard : m_shards) {
+	    std::scoped_lock ml(shard.m_mutex);
+	    expire(shard, issue.ptime());
+	}
+    }
+
+    uint64_t key = callSiteHash(issue.context());
+    Shard& shard = m_shards[key >> (64 - ShardBits)];
 
-    std::scoped_lock ml(m_mutex);
-    throttle( m_issueMap[issueId], issue );
+    std::scoped_lock ml(shard.m_mutex);
+    IssueRecord& record = findRecord(shard, key, issue.ptime());
+    if (m_tokenBucket) {
+	limitRate( record, issue );
+    }
+    else {
+	throttle( record, issue );
+    }
 }
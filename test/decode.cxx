@@ -0,0 +1,108 @@
+/*
+ *  decode.cxx
+ *  Test
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file decode.cxx
+  * Writes issues with parameters, qualifiers and chained causes to a file with the "binfile" stream and checks
+  * that the ers_decode utility, which is given as the only argument, prints them exactly as they are printed
+  * by the text streams.
+  */
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <ers/ers.h>
+#include <ers/Configuration.h>
+#include <ers/OutputStream.h>
+#include <ers/SampleIssues.h>
+#include <ers/StandardStreamOutput.h>
+#include <ers/StreamFactory.h>
+
+namespace
+{
+    const char * const FileName = "ers_test_decode.ers";
+    const int Verbosity = 2;
+
+    bool fail( const std::string & message )
+    {
+	std::cerr << "binfile test failed: " << message << std::endl;
+	return false;
+    }
+
+    bool write_file( std::string & expected )
+    {
+	std::unique_ptr<ers::OutputStream> stream(
+		ers::StreamFactory::instance().create_out_stream( std::string( "binfile(" ) + FileName + ")" ) );
+	if ( !stream )
+	    return fail( "can not create the stream" );
+
+	std::ostringstream out;
+	for ( int i = 0; i < 10; ++i )
+	{
+	    ers::FileDoesNotExist cause( ERS_HERE, ( "file #" + std::to_string( i ) ).c_str() );
+	    ers::PermissionDenied issue( ERS_HERE, "directory", 0x700 + i, cause );
+	    issue.add_qualifier( "ers_test" );
+	    issue.set_severity( i % 2 ? ers::Warning : ers::Error );
+
+	    stream->write( issue );
+	    ers::StandardStreamOutput::println( out, issue, Verbosity );
+	}
+	expected = out.str();
+	return true;
+    }
+
+    bool read_file( const char * decoder, const std::string & expected )
+    {
+	std::string command = std::string( decoder ) + " -v " + std::to_string( Verbosity ) + " " + FileName;
+	FILE * out = ::popen( command.c_str(), "r" );
+	if ( !out )
+	    return fail( "can not run " + command );
+
+	std::string decoded;
+	char buffer[4096];
+	size_t size;
+	while ( ( size = fread( buffer, 1, sizeof( buffer ), out ) ) > 0 )
+	    decoded.append( buffer, size );
+
+	if ( ::pclose( out ) )
+	    return fail( command + " has failed" );
+
+	if ( decoded != expected )
+	    return fail( "decoded issues are different from the original ones:\n" + decoded + "\nexpected:\n" + expected );
+	return true;
+    }
+}
+
+int main( int ac, char ** av )
+{
+    if ( ac != 2 )
+    {
+	std::cerr << "Usage: " << av[0] << " ers_decode" << std::endl;
+	return 2;
+    }
+
+    // loads the library which provides the stream
+    ers::StreamManager::instance();
+
+    // causes are always printed with the global verbosity level, the same way as ers_decode does
+    ers::Configuration::instance().verbosity_level( Verbosity );
+
+    // the stream appends issues to an existing file
+    ::unlink( FileName );
+
+    std::string expected;
+    if ( !write_file( expected ) || !read_file( av[1], expected ) )
+	return 1;
+
+    ::unlink( FileName );
+    return 0;
+}
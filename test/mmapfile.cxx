@@ -0,0 +1,147 @@
+/*
+ *  mmapfile.cxx
+ *  Test
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file mmapfile.cxx
+  * Writes issues of different lengths to a small file with the "mmapfile" stream, until the file is full,
+  * marks one of the records as incomplete, as if its writer has crashed, and checks that the ers_read_mmapfile
+  * utility, which is given as the only argument, prints all the other records in the right order. Then the stream
+  * is created again and the test checks that the previous file is still available under the ".1" name.
+  */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ers/ers.h>
+#include <ers/StreamFactory.h>
+#include <ers/internal/MappedFileStream.h>
+
+namespace
+{
+    const char * const FileName = "ers_test_mmapfile.mmap";
+    const int IssuesNumber = 100;
+    const int CrashedIssue = 1;
+
+    bool fail( const std::string & message )
+    {
+	std::cerr << "mmapfile test failed: " << message << std::endl;
+	return false;
+    }
+
+    bool mark_incomplete( int index )
+    {
+	int fd = ::open( FileName, O_RDWR );
+	if ( fd < 0 )
+	    return fail( "can not open the file" );
+
+	off_t size = ::lseek( fd, 0, SEEK_END );
+	char * data = static_cast<char *>( ::mmap( 0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 ) );
+	::close( fd );
+	if ( data == MAP_FAILED )
+	    return fail( "can not map the file" );
+
+	const ers::MappedFileHeader * header = reinterpret_cast<const ers::MappedFileHeader *>( data );
+	uint64_t offset = header->data_offset;
+	for ( int i = 0; i < index; ++i )
+	{
+	    const ers::MappedRecordHeader * record = reinterpret_cast<const ers::MappedRecordHeader *>( data + offset );
+	    offset += ers::MappedRecordHeader::record_size( record->size );
+	}
+	reinterpret_cast<ers::MappedRecordHeader *>( data + offset )->state = ers::MappedRecordHeader::Reserved;
+
+	::munmap( data, size );
+	return true;
+    }
+
+    bool write_file( )
+    {
+	std::unique_ptr<ers::OutputStream> stream(
+		ers::StreamFactory::instance().create_out_stream( std::string( "mmapfile(" ) + FileName + ",4K)" ) );
+	if ( !stream )
+	    return fail( "can not create the stream" );
+
+	for ( int i = 0; i < IssuesNumber; ++i )
+	{
+	    stream->write( ers::Message( ERS_HERE, "message #" + std::to_string( i ) + " " + std::string( i * 7 % 50, 'x' ) ) );
+	}
+	return true;
+    }
+
+    bool read_file( const char * reader, const std::string & file_name )
+    {
+	std::string command = std::string( reader ) + " " + file_name + " 2>&1";
+	FILE * out = ::popen( command.c_str(), "r" );
+	if ( !out )
+	    return fail( "can not run " + command );
+
+	std::vector<int> printed;
+	int incomplete = 0;
+	bool dropped = false;
+	char line[1024];
+	while ( fgets( line, sizeof( line ), out ) )
+	{
+	    std::string text( line );
+	    std::string::size_type pos = text.find( "message #" );
+	    if ( pos != std::string::npos )
+		printed.push_back( std::stoi( text.substr( pos + 9 ) ) );
+	    else if ( text.find( "Incomplete record" ) != std::string::npos )
+		++incomplete;
+	    else if ( text.find( "did not fit into the file" ) != std::string::npos )
+		dropped = true;
+	}
+	if ( ::pclose( out ) )
+	    return fail( command + " has failed" );
+
+	if ( incomplete != 1 )
+	    return fail( "the incomplete record has not been reported" );
+	if ( !dropped || printed.empty() || printed.back() >= IssuesNumber - 1 )
+	    return fail( "the file has not been filled up" );
+
+	for ( int i = 0, n = 0; i <= printed.back(); ++i )
+	{
+	    if ( i == CrashedIssue )
+		continue;
+	    if ( printed[n++] != i )
+		return fail( "message #" + std::to_string( i ) + " has not been printed" );
+	}
+	return true;
+    }
+}
+
+int main( int ac, char ** av )
+{
+    if ( ac != 2 )
+    {
+	std::cerr << "Usage: " << av[0] << " ers_read_mmapfile" << std::endl;
+	return 2;
+    }
+
+    // loads the library which provides the stream
+    ers::StreamManager::instance();
+
+    std::string previous = std::string( FileName ) + ".1";
+    ::unlink( FileName );
+    ::unlink( previous.c_str() );
+
+    if (    !write_file()
+	 || !mark_incomplete( CrashedIssue )
+	 || !read_file( av[1], FileName )
+	 || !write_file()
+	 || !read_file( av[1], previous ) )
+	return 1;
+
+    ::unlink( FileName );
+    ::unlink( previous.c_str() );
+    return 0;
+}
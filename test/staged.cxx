@@ -0,0 +1,97 @@
+/*
+ *  staged.cxx
+ *  Test
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file staged.cxx
+  * Writes lines of different lengths with the "sfile" stream, which uses the smallest staging buffer, so that
+  * the buffer wraps around many times at all the possible offsets, and checks that the file contains all the
+  * lines in the right order and without any damage.
+  */
+
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <ers/ers.h>
+#include <ers/OutputStream.h>
+#include <ers/StreamFactory.h>
+
+namespace
+{
+    const char * const FileName = "ers_test_staged.log";
+    const int LinesNumber = 2000;
+    // the writer is waited for after this number of lines, which always fit into the buffer together
+    const int FlushPeriod = 8;
+
+    bool fail( const std::string & message )
+    {
+	std::cerr << "staged stream test failed: " << message << std::endl;
+	return false;
+    }
+
+    std::string text( int i )
+    {
+	return "line #" + std::to_string( i ) + " " + std::string( i * 37 % 301, 'a' + i % 26 );
+    }
+
+    bool write_file( )
+    {
+	std::unique_ptr<ers::OutputStream> stream(
+		ers::StreamFactory::instance().create_out_stream( std::string( "sfile(" ) + FileName + ",1,4K)" ) );
+	if ( !stream )
+	    return fail( "can not create the stream" );
+
+	for ( int i = 0; i < LinesNumber; ++i )
+	{
+	    stream->write( ers::Message( ERS_HERE, text( i ) ) );
+	    if ( i % FlushPeriod == FlushPeriod - 1 )
+		stream->flush();
+	}
+	stream->flush();
+	return true;
+    }
+
+    bool read_file( )
+    {
+	std::ifstream in( FileName );
+	if ( !in )
+	    return fail( "can not open the file" );
+
+	int n = 0;
+	std::string line;
+	while ( std::getline( in, line ) )
+	{
+	    std::string::size_type pos = line.find( "line #" );
+	    if ( pos == std::string::npos )
+		return fail( "unexpected line \"" + line + "\"" );
+	    if ( n == LinesNumber || line.compare( pos, std::string::npos, text( n ) ) )
+		return fail( "line #" + std::to_string( n ) + " is damaged or missing: \"" + line + "\"" );
+	    ++n;
+	}
+	if ( n != LinesNumber )
+	    return fail( "only " + std::to_string( n ) + " lines have been written" );
+	return true;
+    }
+}
+
+int main( int , char ** )
+{
+    // loads the library which provides the stream
+    ers::StreamManager::instance();
+
+    // the stream appends lines to an existing file
+    ::unlink( FileName );
+
+    if ( !write_file() || !read_file() )
+	return 1;
+
+    ::unlink( FileName );
+    return 0;
+}